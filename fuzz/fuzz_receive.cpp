@@ -0,0 +1,333 @@
+/*
+@brief Coverage guided fuzzer for the firmware's receive path
+@details Every input is a byte stream as it could arrive from the HC-12. It is fed one byte at a time through the real
+         receiveRadio() of src/main.cpp, so the receive parser, handleFrame(), the text and element stream decoders,
+         the credit, benchmark and hop handlers and the playback queue all run as on the device, built against the
+         host Arduino core in fuzz/host/. After every byte it checks that
+         - no memory outside the firmware's buffers was touched (AddressSanitizer)
+         - nothing was allocated, so memory stays bounded
+         - the parser invariants hold
+         - the byte took less than FUZZ_BYTE_BOUND_US, the time the next byte takes to arrive at 9600 baud
+         and aborts otherwise. The host runs faster than the ATmega328P, so the time bound catches unbounded loops and
+         work that grows with the input rather than the exact time on the device.
+
+Build and run with libFuzzer, from the repository root:
+  clang++ -std=gnu++17 -g -O1 -fsanitize=fuzzer,address,undefined -Iinclude -Ifuzz/host \
+    fuzz/fuzz_receive.cpp src/[a-z]*.cpp -o fuzz_receive
+  ./fuzz_receive fuzz/corpus
+
+Without clang the same checks run from a built-in mutator:
+  g++ -std=gnu++17 -g -O1 -fsanitize=address,undefined -DFUZZ_STANDALONE -Iinclude -Ifuzz/host \
+    fuzz/fuzz_receive.cpp src/[a-z]*.cpp -o fuzz_receive
+  ./fuzz_receive -runs=100000 fuzz/corpus
+
+The seed corpus in fuzz/corpus/ holds valid element lines and one frame of every type, written by
+./fuzz_receive -write_corpus=fuzz/corpus with the standalone build.
+*/
+
+#include <chrono>                                     // Before Arduino.h, whose min() and max() macros break it
+#include <new>
+#ifdef FUZZ_STANDALONE
+#include <dirent.h>
+#include <vector>
+#endif
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include "element_stream.h"
+#include "frame.h"
+#include "playback.h"
+#include "rx_parser.h"
+#include "text_compress.h"
+
+// From src/main.cpp
+extern SoftwareSerial morse;
+extern RxParser radioParser;
+void setup();
+void receiveRadio();
+void loopPlayback();
+extern unsigned long elementsReceived;
+extern unsigned long framesReceived;
+extern unsigned long framesDropped;
+extern unsigned long invalidReceived;
+
+static const unsigned long FUZZ_BYTE_BOUND_US = 1041; // One byte at 9600 baud, 10 bits
+static const unsigned long BYTE_TIME_US = 1042;       // Simulated time between bytes
+static const uint8_t FUZZ_RETRIES = 3;                // Reruns before a slow byte counts, to skip host preemption
+
+static unsigned long allocations = 0;
+
+void* operator new(size_t _size) {
+  allocations++;
+  void* memory = malloc(_size ? _size : 1);
+  if (memory == 0) {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+void* operator new[](size_t _size) {
+  return operator new(_size);
+}
+
+void operator delete(void* _memory) noexcept {
+  free(_memory);
+}
+
+void operator delete[](void* _memory) noexcept {
+  free(_memory);
+}
+
+void operator delete(void* _memory, size_t) noexcept {
+  free(_memory);
+}
+
+void operator delete[](void* _memory, size_t) noexcept {
+  free(_memory);
+}
+
+static void check(bool _condition, const char* _message) {
+  if (!_condition) {
+    fprintf(stderr, "FUZZ FAIL: %s\n", _message);
+    abort();
+  }
+}
+
+static void begin() {
+  static bool started = false;
+  if (!started) {
+    setup();                                          // Pins, HC-12, parser and playback as on the device
+    started = true;
+  }
+}
+
+/*
+@brief Feeds one input through the receive path
+@return The slowest byte in microseconds
+*/
+static long receiveInput(const uint8_t* _data, size_t _size) {
+  rxParserReset(radioParser);                         // Every input starts from a fresh stream
+  playbackReset();
+  morse.hostClear();
+
+  long slowest = 0;
+  unsigned long allocated = allocations;
+  for (size_t i = 0; i < _size; i++) {
+    morse.hostFeed(_data[i]);
+
+    auto start = std::chrono::steady_clock::now();
+    while (morse.available()) {
+      receiveRadio();
+    }
+    loopPlayback();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    if (elapsed.count() > slowest) {
+      slowest = elapsed.count();
+    }
+    check(rxParserValid(radioParser), "receive parser invariants broken");
+    check(playbackQueued() + playbackFree() == PLAYBACK_QUEUE_SIZE, "playback queue out of range");
+    hostAdvance(BYTE_TIME_US);
+  }
+  check(allocations == allocated, "receive path allocated memory");
+  return slowest;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* _data, size_t _size) {
+  begin();
+  long slowest = receiveInput(_data, _size);
+  for (uint8_t retry = 0; retry < FUZZ_RETRIES && slowest >= (long)FUZZ_BYTE_BOUND_US; retry++) {
+    long again = receiveInput(_data, _size);          // The host may have been preempted, inputs are deterministic
+    if (again < slowest) {
+      slowest = again;
+    }
+  }
+  check(slowest < (long)FUZZ_BYTE_BOUND_US, "byte took longer than the next one takes to arrive");
+  return 0;
+}
+
+#ifdef FUZZ_STANDALONE
+
+typedef std::vector<uint8_t> Input;
+
+static Input frameInput(uint8_t _type, const uint8_t* _payload, uint8_t _length) {
+  uint8_t buffer[FRAME_MAX_SIZE];
+  uint8_t size = frameEncode(_type, _payload, _length, buffer);
+  return Input(buffer, buffer + size);
+}
+
+/*
+@brief Valid element lines and one frame of every type the receive path handles
+*/
+static std::vector<Input> seeds() {
+  std::vector<Input> inputs;
+  const char* lines = "1\r\n2\r\n1\r\n";
+  inputs.push_back(Input(lines, lines + strlen(lines)));
+
+  const uint8_t text[] = "CQ CQ DE PARIS K";
+  uint8_t compressed[FRAME_MAX_PAYLOAD];
+  inputs.push_back(frameInput(FRAME_TEXT, compressed, textCompress(text, sizeof(text) - 1, compressed, sizeof(compressed))));
+
+  uint8_t bits[8];
+  ElementStream stream;
+  elementStreamInit(stream, bits, sizeof(bits));
+  const uint8_t items[] = {ELEMENT_DOT, ELEMENT_DASH, ELEMENT_CHARACTER_GAP, ELEMENT_DASH, ELEMENT_WORD_GAP};
+  for (uint8_t i = 0; i < sizeof(items); i++) {
+    elementStreamAppend(stream, items[i]);
+  }
+  uint8_t encoded[VARINT_MAX_SIZE + sizeof(bits)];
+  inputs.push_back(frameInput(FRAME_ELEMENTS, encoded, elementStreamEncode(stream, encoded, sizeof(encoded))));
+
+  const uint8_t wrapping[] = {0xFF, 0xFF, 0x03};      // Element stream count that wrapped in 16 bit
+  inputs.push_back(frameInput(FRAME_ELEMENTS, wrapping, sizeof(wrapping)));
+
+  const uint8_t credit[] = {100, 0, 3};
+  inputs.push_back(frameInput(FRAME_CREDIT, credit, sizeof(credit)));
+  inputs.push_back(frameInput(FRAME_CREDIT, 0, 0));
+
+  const uint8_t benchmarkStart[] = {2};
+  const uint8_t benchmarkEnd[] = {3};
+  const uint8_t benchmarkReport[] = {4, 44, 1, 0x10, 0x27, 0, 0};
+  inputs.push_back(frameInput(FRAME_BENCHMARK, benchmarkStart, sizeof(benchmarkStart)));
+  inputs.push_back(frameInput(FRAME_BENCHMARK, benchmarkEnd, sizeof(benchmarkEnd)));
+  inputs.push_back(frameInput(FRAME_BENCHMARK, benchmarkReport, sizeof(benchmarkReport)));
+
+  const uint8_t hop[] = {5, 0, 0, 0, 250, 0, 0, 0, 0, 0, 0};
+  inputs.push_back(frameInput(FRAME_HOP, hop, sizeof(hop)));
+
+  uint8_t secure[FRAME_MAX_WIRE_PAYLOAD];
+  for (uint8_t i = 0; i < sizeof(secure); i++) {
+    secure[i] = i * 37;
+  }
+  inputs.push_back(frameInput(FRAME_SECURE, secure, 14));
+  return inputs;
+}
+
+static uint32_t randomState = 1;
+
+static uint32_t nextRandom() {
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+/*
+@brief Flip, insert, delete, splice and truncate, a few times over
+*/
+static Input mutate(const std::vector<Input>& _corpus) {
+  Input input = _corpus[nextRandom() % _corpus.size()];
+  uint8_t steps = 1 + nextRandom() % 8;
+
+  for (uint8_t s = 0; s < steps; s++) {
+    size_t position = input.empty() ? 0 : nextRandom() % input.size();
+    switch (nextRandom() % 6) {
+      case 0:
+        if (!input.empty()) {
+          input[position] ^= 1 << (nextRandom() % 8);
+        }
+        break;
+      case 1:
+        if (!input.empty()) {
+          input[position] = (uint8_t)nextRandom();
+        }
+        break;
+      case 2:
+        input.insert(input.begin() + position, (uint8_t)nextRandom());
+        break;
+      case 3:
+        if (!input.empty()) {
+          input.erase(input.begin() + position);
+        }
+        break;
+      case 4: {
+        const Input& other = _corpus[nextRandom() % _corpus.size()];
+        input.insert(input.begin() + position, other.begin(), other.end());
+        break;
+      }
+      default:
+        input.resize(position);
+        break;
+    }
+  }
+  if (input.size() > 512) {
+    input.resize(512);
+  }
+  return input;
+}
+
+static bool readFile(const char* _path, Input& _input) {
+  FILE* file = fopen(_path, "rb");
+  if (file == 0) {
+    return false;
+  }
+  int value;
+  while ((value = fgetc(file)) != EOF) {
+    _input.push_back((uint8_t)value);
+  }
+  fclose(file);
+  return true;
+}
+
+static void readDirectory(const char* _path, std::vector<Input>& _corpus) {
+  DIR* directory = opendir(_path);
+  if (directory == 0) {
+    Input input;
+    if (readFile(_path, input)) {
+      _corpus.push_back(input);
+    }
+    return;
+  }
+  while (dirent* entry = readdir(directory)) {
+    if (entry->d_name[0] != '.') {
+      char path[512];
+      Input input;
+      snprintf(path, sizeof(path), "%s/%s", _path, entry->d_name);
+      if (readFile(path, input)) {
+        _corpus.push_back(input);
+      }
+    }
+  }
+  closedir(directory);
+}
+
+int main(int _argc, char** _argv) {
+  std::vector<Input> corpus = seeds();
+  unsigned long runs = 10000;
+
+  for (int i = 1; i < _argc; i++) {
+    if (strncmp(_argv[i], "-runs=", 6) == 0) {
+      runs = strtoul(_argv[i] + 6, 0, 10);
+    } else if (strncmp(_argv[i], "-seed=", 6) == 0) {
+      randomState = strtoul(_argv[i] + 6, 0, 10);
+      if (randomState == 0) {
+        randomState = 1;                                // Xorshift stays at zero
+      }
+    } else if (strncmp(_argv[i], "-write_corpus=", 14) == 0) {
+      std::vector<Input> inputs = seeds();
+      for (size_t s = 0; s < inputs.size(); s++) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/seed_%02u", _argv[i] + 14, (unsigned)s);
+        FILE* file = fopen(path, "wb");
+        check(file != 0, "cannot write the corpus");
+        fwrite(inputs[s].data(), 1, inputs[s].size(), file);
+        fclose(file);
+      }
+      return 0;
+    } else {
+      readDirectory(_argv[i], corpus);
+    }
+  }
+
+  for (size_t i = 0; i < corpus.size(); i++) {
+    LLVMFuzzerTestOneInput(corpus[i].data(), corpus[i].size());
+  }
+  for (unsigned long run = 0; run < runs; run++) {
+    Input input = mutate(corpus);
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+  }
+  printf("%lu inputs, %lu elements, %lu frames, %lu damaged frames, %lu invalid messages received\nPASS\n",
+         (unsigned long)corpus.size() + runs, elementsReceived, framesReceived, framesDropped, invalidReceived);
+  return 0;
+}
+
+#endif
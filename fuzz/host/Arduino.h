@@ -0,0 +1,302 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+@brief Just enough of the Arduino core to run the firmware on the host, for the fuzz harness in fuzz/ and the two
+       node test in test/test_two_node/
+@details Time is simulated: millis() and micros() only move when hostAdvance() or delay() moves them, so blocking
+         waits in the firmware cost nothing and every run is repeatable. Pins, registers and EEPROM are plain memory.
+         Nothing here allocates, so the harness can check that the receive path does not either.
+@details Everything is header only and free of global symbols the linker would see twice, so the two node test can
+         include the core and the whole firmware once per node, each inside its own namespace.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/pgmspace.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+class __FlashStringHelper;                            // Strings in flash on the AVR, see F()
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define DEC 10
+#define HEX 16
+#define BIN 2
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define F_CPU 16000000UL
+#define F(_string) (reinterpret_cast<const __FlashStringHelper*>(_string))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define constrain(x, a, b) ((x) < (a) ? (a) : ((x) > (b) ? (b) : (x)))
+#define ISR(_vector) void _vector()                // Never called, the harness drives the firmware from loop()
+
+inline uint64_t hostMicros = 0;                       // Simulated time
+inline uint8_t hostPins[20];
+inline bool hostEcho = false;                         // Set to print everything the firmware prints
+
+inline void hostAdvance(unsigned long _micros) {
+  hostMicros += _micros;
+}
+
+inline unsigned long millis() {
+  return (unsigned long)(hostMicros / 1000);
+}
+
+inline unsigned long micros() {
+  return (unsigned long)hostMicros;
+}
+
+inline void delay(unsigned long _milliseconds) {
+  hostAdvance(_milliseconds * 1000);
+}
+
+inline void delayMicroseconds(unsigned int _micros) {
+  hostAdvance(_micros);
+}
+
+inline void pinMode(uint8_t _pin, uint8_t _mode) {
+  if (_mode == INPUT_PULLUP) {
+    hostPins[_pin % 20] = HIGH;                       // Idles high until the harness pulls it low, like the button
+  }
+}
+
+inline void digitalWrite(uint8_t _pin, uint8_t _value) {
+  hostPins[_pin % 20] = _value;
+}
+
+inline int digitalRead(uint8_t _pin) {
+  return _pin < 20 && hostPins[_pin] == LOW ? LOW : HIGH;
+}
+
+inline int analogRead(uint8_t) {
+  return 512;
+}
+
+inline void noInterrupts() {}
+inline void interrupts() {}
+inline void randomSeed(unsigned long _seed) {
+  srand((unsigned)_seed);
+}
+inline long random(long _max) {
+  return _max > 0 ? rand() % _max : 0;
+}
+inline long random(long _min, long _max) {
+  return _min + random(_max - _min);
+}
+
+// AVR registers touched by the ADC sampler and the tone input
+inline volatile uint8_t ADCH, ADCL, ADCSRA, ADCSRB, ADMUX, TCCR1A, TCCR1B, TIMSK1, DIDR0, TIFR1, SREG;
+inline volatile uint16_t ADC, TCNT1, OCR1A, OCR1B, ICR1;
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS2 2
+#define ADPS1 1
+#define ADPS0 0
+#define REFS0 6
+#define ADLAR 5
+#define ADTS2 2
+#define ADTS1 1
+#define ADTS0 0
+#define WGM12 3
+#define WGM13 4
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define OCIE1A 1
+#define OCIE1B 2
+#define OCF1B 2
+#define TOIE1 0
+
+// Fixed size string, only what the firmware uses of Arduino's String
+class String {
+ public:
+  String(const char* _text = "") {
+    strncpy(text, _text, sizeof(text) - 1);
+  }
+  bool startsWith(const char* _prefix) const {
+    return strncmp(text, _prefix, strlen(_prefix)) == 0;
+  }
+  long toInt() const {
+    return atol(text);
+  }
+  unsigned length() const {
+    return strlen(text);
+  }
+  const char* c_str() const {
+    return text;
+  }
+  char text[64] = {0};
+};
+
+class Print {
+ public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t _value) = 0;
+  virtual size_t write(const uint8_t* _data, size_t _length) {
+    for (size_t i = 0; i < _length; i++) {
+      write(_data[i]);
+    }
+    return _length;
+  }
+  size_t write(const char* _text) {
+    return write((const uint8_t*)_text, strlen(_text));
+  }
+  virtual void flush() {}
+
+  size_t print(const char* _text) {
+    return write(_text);
+  }
+  size_t print(const __FlashStringHelper* _text) {
+    return write(reinterpret_cast<const char*>(_text));
+  }
+  size_t print(const String& _text) {
+    return write(_text.c_str());
+  }
+  size_t print(char _value) {
+    return write((uint8_t)_value);
+  }
+  size_t print(unsigned long _value, int _base = DEC) {
+    char text[40];
+    char* end = text + sizeof(text) - 1;
+    *end = '\0';
+    do {
+      *--end = "0123456789ABCDEF"[_value % _base];
+      _value /= _base;
+    } while (_value != 0);
+    return write(end);
+  }
+  size_t print(long _value, int _base = DEC) {
+    if (_value < 0 && _base == DEC) {
+      return write((uint8_t)'-') + print((unsigned long)-_value, DEC);
+    }
+    return print((unsigned long)_value, _base);
+  }
+  size_t print(unsigned char _value, int _base = DEC) {
+    return print((unsigned long)_value, _base);
+  }
+  size_t print(int _value, int _base = DEC) {
+    return print((long)_value, _base);
+  }
+  size_t print(unsigned int _value, int _base = DEC) {
+    return print((unsigned long)_value, _base);
+  }
+  size_t print(double _value, int _digits = 2) {
+    char text[40];
+    snprintf(text, sizeof(text), "%.*f", _digits, _value);
+    return write(text);
+  }
+
+  size_t println() {
+    return write("\r\n");
+  }
+  template <class T>
+  size_t println(T _value) {
+    return print(_value) + println();
+  }
+  template <class T>
+  size_t println(T _value, int _format) {
+    return print(_value, _format) + println();
+  }
+};
+
+// Byte queues standing in for a serial port: input is fed by the harness, output is kept for it to take with the time
+// it was written, the newest bytes are dropped when it does not
+class Stream : public Print {
+ public:
+  virtual int available() {
+    return (int)(inputEnd - inputStart);
+  }
+  virtual int read() {
+    return inputStart < inputEnd ? input[inputStart++ % sizeof(input)] : -1;
+  }
+  virtual int peek() {
+    return inputStart < inputEnd ? input[inputStart % sizeof(input)] : -1;
+  }
+  size_t write(uint8_t _value) override {
+    written++;
+    if (hostEcho) {
+      fputc(_value, stderr);
+    }
+    if (outputEnd - outputStart < sizeof(output)) {
+      output[outputEnd % sizeof(output)] = _value;
+      outputTime[outputEnd++ % sizeof(output)] = hostMicros;
+    }
+    return 1;
+  }
+  using Print::write;
+  String readStringUntil(char _terminator) {
+    String line;
+    size_t length = 0;
+    int value;
+    while ((value = read()) >= 0 && value != _terminator) {
+      if (length < sizeof(line.text) - 1) {
+        line.text[length++] = (char)value;
+      }
+    }
+    return line;
+  }
+  void setTimeout(unsigned long) {}
+
+  bool hostFeed(uint8_t _value) {                     // Drops the byte when full, like a real receive buffer
+    if (inputEnd - inputStart >= sizeof(input)) {
+      return false;
+    }
+    input[inputEnd++ % sizeof(input)] = _value;
+    return true;
+  }
+  void hostClear() {
+    inputStart = inputEnd = 0;
+    outputStart = outputEnd = 0;
+  }
+  int hostTake(uint64_t* _time = 0) {                 // Oldest byte written, -1 if none
+    if (outputStart == outputEnd) {
+      return -1;
+    }
+    if (_time != 0) {
+      *_time = outputTime[outputStart % sizeof(output)];
+    }
+    return output[outputStart++ % sizeof(output)];
+  }
+
+  uint8_t input[64];
+  size_t inputStart = 0;
+  size_t inputEnd = 0;
+  uint8_t output[256];
+  uint64_t outputTime[256];
+  size_t outputStart = 0;
+  size_t outputEnd = 0;
+  unsigned long written = 0;
+};
+
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long) {}
+  int availableForWrite() {
+    return 63;
+  }
+  explicit operator bool() {
+    return true;
+  }
+};
+
+inline HardwareSerial Serial;
+
+#endif
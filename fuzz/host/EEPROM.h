@@ -0,0 +1,21 @@
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stdint.h>
+
+struct EEPROMClass {
+  uint8_t read(int _address) {
+    return memory[_address & 1023];
+  }
+  void write(int _address, uint8_t _value) {
+    memory[_address & 1023] = _value;
+  }
+  void update(int _address, uint8_t _value) {
+    write(_address, _value);
+  }
+  uint8_t memory[1024];
+};
+
+inline EEPROMClass EEPROM;
+
+#endif
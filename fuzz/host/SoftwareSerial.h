@@ -0,0 +1,29 @@
+#ifndef HOST_SOFTWARE_SERIAL_H
+#define HOST_SOFTWARE_SERIAL_H
+
+#include "Arduino.h"
+
+// Writing blocks for one byte time per byte, as the bit banged transmitter does
+class SoftwareSerial : public Stream {
+ public:
+  SoftwareSerial(uint8_t, uint8_t) {}
+  void begin(long _baudRate) {
+    byteTime = 10000000UL / _baudRate;
+  }
+  bool listen() {
+    return true;
+  }
+  bool overflow() {
+    return false;
+  }
+  void end() {}
+  size_t write(uint8_t _value) override {
+    hostAdvance(byteTime);
+    return Stream::write(_value);
+  }
+  using Stream::write;
+
+  unsigned long byteTime = 1041;                      // 9600 baud
+};
+
+#endif
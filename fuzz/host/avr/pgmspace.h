@@ -0,0 +1,15 @@
+#ifndef HOST_PGMSPACE_H
+#define HOST_PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PSTR(_string) (_string)
+#define pgm_read_byte(_address) (*(const uint8_t*)(_address))
+#define pgm_read_word(_address) (*(const uint16_t*)(_address))
+#define pgm_read_dword(_address) (*(const uint32_t*)(_address))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+#endif
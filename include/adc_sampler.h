@@ -0,0 +1,47 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <Arduino.h>
+
+/*
+@brief Double buffered ADC sampling without the CPU starting conversions
+@details Timer1 compare match B auto-triggers the ADC at the sample rate. The ADC interrupt only stores the 8-bit
+         result into the block being filled. When a block is full it is handed to the main loop and the interrupt
+         continues in the other block, so one block is processed while the other fills.
+@details If the main loop still holds the previous block when the next one fills, that block is overwritten and
+         counted as an overrun. Block sequence numbers keep counting, so timestamps derived from them stay exact
+         across overruns.
+*/
+
+const uint8_t ADC_BLOCK_SIZE = 80;                    // Samples per block
+
+/*
+@brief Start sampling an analog pin
+@param _analogPin Analog input to sample
+@param _sampleRate Samples per second, between 1 kHz and 9 kHz
+*/
+void adcSamplerBegin(uint8_t _analogPin, uint16_t _sampleRate);
+
+/*
+@brief Stop sampling and release Timer1 and the ADC
+*/
+void adcSamplerEnd();
+
+/*
+@brief Get the next full block
+@param _sequence Receives the sequence number of the block, counting from 0 at adcSamplerBegin()
+@return The block samples, NULL if no block is ready. The block stays valid until adcSamplerRelease().
+*/
+const uint8_t* adcSamplerBlock(uint32_t* _sequence);
+
+/*
+@brief Hand the block from adcSamplerBlock() back to the sampler
+*/
+void adcSamplerRelease();
+
+/*
+@brief Number of blocks lost because the main loop did not release the previous block in time
+*/
+uint16_t adcSamplerOverruns();
+
+#endif
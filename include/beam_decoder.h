@@ -0,0 +1,51 @@
+#ifndef BEAM_DECODER_H
+#define BEAM_DECODER_H
+
+#include <stdint.h>
+
+/*
+@brief Beam search decoder for sloppy keying
+@details Instead of classifying each press against a fixed threshold, the decoder keeps the BEAM_WIDTH most
+         likely interpretations of the character being keyed. Every mark is scored as a dot and as a dash and
+         every space inside the character is scored as an element gap and as a character gap, so a badly timed
+         element or a short pause between two characters can still be decoded correctly. Interpretations that
+         are not a prefix of any Morse symbol are dropped. The cheapest complete interpretation is emitted once
+         the caller sees the character gap.
+@details Costs are the relative timing error in 1/64 units against the adaptive dot estimate, which is updated
+         from every decoded character. All math is 16-bit integer so a mark costs a few hundred cycles on AVR.
+*/
+
+const uint8_t BEAM_WIDTH = 4;                         // Number of interpretations kept per character
+const uint8_t BEAM_MAX_MARKS = 12;                    // Marks remembered per character, up to two symbols
+
+/*
+@brief Reset the decoder
+@param _dotDuration Initial dot estimate in milliseconds
+*/
+void beamDecoderInit(uint16_t _dotDuration);
+
+/*
+@brief Feed one mark (key press) into the decoder
+@param _duration Mark duration in milliseconds
+@param _gapBefore Space since the previous mark in milliseconds, ignored for the first mark of a character
+*/
+void beamDecoderMark(uint16_t _duration, uint16_t _gapBefore);
+
+/*
+@brief Check if marks have been fed since the last beamDecoderFinish()
+*/
+bool beamDecoderBusy();
+
+/*
+@brief Emit the most likely symbols for the marks fed so far and start a new character
+@param _symbols Receives up to two symbols (a short character gap can split the marks into two)
+@return Number of symbols written, 0 if no interpretation was a valid symbol
+*/
+uint8_t beamDecoderFinish(uint8_t* _symbols);
+
+/*
+@brief Current dot estimate in milliseconds
+*/
+uint16_t beamDecoderDotEstimate();
+
+#endif
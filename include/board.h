@@ -0,0 +1,26 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+/*
+@brief Selects the pin map of the hardware revision the firmware is built for
+@details Build with -D BOARD=BOARD_REV_B (see the envs in platformio.ini) to pick another revision than the default.
+         Each revision has its own header in include/boards/ with the same constexpr pin constants, so the choice is
+         made entirely by the compiler and costs nothing at run time.
+*/
+
+#define BOARD_REV_A 1                                 // include/boards/rev_a.h, the default
+#define BOARD_REV_B 2                                 // include/boards/rev_b.h
+
+#ifndef BOARD
+#define BOARD BOARD_REV_A
+#endif
+
+#if BOARD == BOARD_REV_A
+#include "boards/rev_a.h"
+#elif BOARD == BOARD_REV_B
+#include "boards/rev_b.h"
+#else
+#error "Unknown BOARD, use one of the BOARD_REV_* values in include/board.h"
+#endif
+
+#endif
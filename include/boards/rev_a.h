@@ -0,0 +1,19 @@
+#ifndef BOARDS_REV_A_H
+#define BOARDS_REV_A_H
+
+#include <Arduino.h>
+
+/*
+@brief Pin map of hardware revision A, the wiring shown in the README
+*/
+
+constexpr const char* BOARD_NAME = "Rev A";
+constexpr uint8_t BUTTON_PIN = 2;                     // Momentary push-button switch accross pin 2 and GND
+constexpr uint8_t LED_PIN = 4;                        // 5mm Red LED with current limiting resistor accross pin 4 and GND
+constexpr uint8_t BUZZER_PIN = 6;                     // 5V Active Buzzer accross pin 6 and GND
+constexpr uint8_t HC12_SET_PIN = 8;                   // HC-12 SET pin for configuration mode (active low)
+constexpr uint8_t HC12_TX_PIN = 10;                   // HC-12 TX pin connected to Arduino RX pin
+constexpr uint8_t HC12_RX_PIN = 12;                   // HC-12 RX pin connected to Arduino TX pin
+constexpr uint8_t TONE_INPUT_PIN = A1;                // Audio input biased to 2.5 V, e.g. receiver audio through a capacitor and divider
+
+#endif
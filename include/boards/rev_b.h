@@ -0,0 +1,19 @@
+#ifndef BOARDS_REV_B_H
+#define BOARDS_REV_B_H
+
+#include <Arduino.h>
+
+/*
+@brief Pin map of hardware revision B, the wiring the original sketch in src/main.txt was written for
+*/
+
+constexpr const char* BOARD_NAME = "Rev B";
+constexpr uint8_t BUTTON_PIN = 7;                     // Momentary push-button switch accross pin 7 and GND
+constexpr uint8_t LED_PIN = 8;                        // 5mm Red LED with current limiting resistor accross pin 8 and GND
+constexpr uint8_t BUZZER_PIN = A0;                    // 5V Active Buzzer accross pin A0 and GND
+constexpr uint8_t HC12_SET_PIN = 10;                  // HC-12 SET pin for configuration mode (active low)
+constexpr uint8_t HC12_TX_PIN = 12;                   // HC-12 TX pin connected to Arduino RX pin
+constexpr uint8_t HC12_RX_PIN = 11;                   // HC-12 RX pin connected to Arduino TX pin
+constexpr uint8_t TONE_INPUT_PIN = A1;                // Audio input biased to 2.5 V, e.g. receiver audio through a capacitor and divider
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef CHANNEL_SCAN_H
+#define CHANNEL_SCAN_H
+
+#include <Arduino.h>
+
+/*
+@brief Scanning receiver that steps the HC-12 through a list of channels
+@details Each channel is listened to for a short dwell time. A channel that shows activity is held until it has
+         been quiet for the hold time, so a conversation is followed to its end before the scan moves on.
+@details Hops go through channel_switch.h, so they never wait and the HC-12 serial port must not be used while
+         channelSwitchBusy().
+*/
+
+const uint8_t SCAN_MAX_CHANNELS = 8;                  // Longest channel list
+
+/*
+@brief Start scanning
+@param _port Serial port of the HC-12
+@param _setPin Pin driving the HC-12 SET input
+@param _channels Channels to scan, 1 to 100, at most SCAN_MAX_CHANNELS
+@param _count Number of channels
+@param _dwell Time to listen to a quiet channel in milliseconds
+@param _hold Time a channel with activity is held after the last activity in milliseconds
+*/
+void channelScanBegin(Stream& _port, uint8_t _setPin, const uint8_t* _channels, uint8_t _count, unsigned long _dwell,
+                      unsigned long _hold);
+
+/*
+@brief Check if scanning is enabled
+*/
+bool channelScanActive();
+
+/*
+@brief Advance the scan, call once per loop
+@param _now Current time in milliseconds
+@param _activity True if anything was received on the current channel since the last call
+*/
+void channelScanPoll(unsigned long _now, bool _activity);
+
+/*
+@brief Stay on the current channel for the hold time, e.g. because this unit is about to send on it
+@details Does not wait for a hop in progress, only send once channelSwitchBusy() is false.
+*/
+void channelScanHold();
+
+/*
+@brief Channel the HC-12 is on or switching to
+*/
+uint8_t channelScanChannel();
+
+#endif
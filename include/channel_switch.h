@@ -0,0 +1,123 @@
+#ifndef CHANNEL_SWITCH_H
+#define CHANNEL_SWITCH_H
+
+#include <Arduino.h>
+
+/*
+@brief Non-blocking HC-12 channel switch and AT commands
+@details A switch is a state machine advanced by channelSwitchPoll() from loop(), it never waits: SET is driven low,
+         after the module's 40 ms setup time AT+Cxxx is written, the "OK+Cxxx" reply is taken as soon as it arrives,
+         and SET goes high again for the 80 ms the module needs to leave configuration mode. While a switch is in
+         progress the HC-12 serial port belongs to it and nothing may be sent or received through it.
+@details Received bytes are never dropped: what is waiting before SET goes low, arrives while the module enters
+         configuration mode or follows the reply once it is back in normal mode is kept for the receive path, which
+         reads it with channelSwitchRead() before the port, also while the switch is still in progress.
+@details Any other AT command runs the same way through channelSwitchCommand(). Its reply can span several lines,
+         e.g. for AT+RX, so it is collected until the module has been quiet for SWITCH_REPLY_QUIET. The reply to
+         AT+Cxxx ends at its line end.
+@details A bridge keeps the module in configuration mode and passes bytes between it and a console in both directions,
+         so it can be configured by hand. SET is driven with the same timing and the bridge ends by itself once
+         nothing passed either way for its idle timeout.
+*/
+
+const unsigned long SWITCH_SET_LOW_DELAY = 40;        // ms from SET low until the module takes AT commands
+const unsigned long SWITCH_REPLY_TIMEOUT = 100;       // ms to wait for the reply to AT+Cxxx
+const unsigned long SWITCH_SET_HIGH_DELAY = 80;       // ms from SET high until the module is back in normal mode
+const unsigned long SWITCH_REPLY_QUIET = 20;          // ms without a byte that end the reply to other AT commands
+const uint8_t SWITCH_COMMAND_MAX = 24;                // Longest AT command
+const uint8_t SWITCH_REPLY_MAX = 48;                  // Longest reply kept, the rest is dropped
+const uint8_t SWITCH_HANDOFF_MAX = 64;                // Received bytes kept for the receive path, one SoftwareSerial buffer
+
+/*
+@brief Take over the SET pin of the HC-12 and drive it high
+@param _port Serial port of the HC-12
+@param _setPin Pin driving the HC-12 SET input
+*/
+void channelSwitchBegin(Stream& _port, uint8_t _setPin);
+
+/*
+@brief Start switching to a channel
+@details A switch or AT command in progress is left alone, its reply would otherwise be taken for this one. Nothing
+         happens before channelSwitchBegin(), the same goes for the other jobs.
+@param _channel Channel from 1 to 100
+@param _now Current time in milliseconds
+@return False if a switch or AT command is in progress, the caller tries again once channelSwitchBusy() is false
+*/
+bool channelSwitchStart(uint8_t _channel, unsigned long _now);
+
+/*
+@brief Start running an AT command, a switch in progress is finished first
+@param _command Command without line end, at most SWITCH_COMMAND_MAX characters
+@param _length Length of the command
+@param _now Current time in milliseconds
+@return False if the command is too long or channelSwitchBegin() was not called
+*/
+bool channelSwitchCommand(const char* _command, uint8_t _length, unsigned long _now);
+
+/*
+@brief Start passing bytes between a console and the module in configuration mode, a switch in progress is finished
+       first
+@param _console Serial port to bridge, usually the USB serial port
+@param _idleTimeout Time without a byte in either direction after which normal mode is restored, in milliseconds
+@param _now Current time in milliseconds
+*/
+void channelSwitchBridge(Stream& _console, unsigned long _idleTimeout, unsigned long _now);
+
+/*
+@brief Check if a bridge is open or about to open, channelSwitchBusy() stays true until normal mode is restored
+*/
+bool channelSwitchBridging();
+
+/*
+@brief Reply to the last AT command, NUL terminated, without '\r'
+*/
+const char* channelSwitchReply();
+
+/*
+@brief Number of received bytes kept for the receive path
+*/
+uint8_t channelSwitchPending();
+
+/*
+@brief Take the oldest received byte kept for the receive path, only call if channelSwitchPending() is not 0
+*/
+uint8_t channelSwitchRead();
+
+/*
+@brief Advance a switch in progress, call once per loop
+@param _now Current time in milliseconds
+*/
+void channelSwitchPoll(unsigned long _now);
+
+/*
+@brief Wait until a switch in progress is done, which takes at most about 220 ms
+@details An open bridge is closed right away, taking 80 ms.
+*/
+void channelSwitchFinish();
+
+/*
+@brief Check if a switch is in progress, the HC-12 port must not be used until it is done
+*/
+bool channelSwitchBusy();
+
+/*
+@brief Channel the HC-12 is on or switching to, 0 before the first switch
+*/
+uint8_t channelSwitchChannel();
+
+/*
+@brief Number of completed channel switches
+*/
+unsigned long channelSwitchCount();
+
+/*
+@brief Average time a switch takes in milliseconds
+*/
+unsigned long channelSwitchTime();
+
+/*
+@brief Number of channel switches the module did not confirm
+*/
+unsigned long channelSwitchFailures();
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef DSP_H
+#define DSP_H
+
+#include <stdint.h>
+
+/*
+@brief Fixed-point DSP kernels
+@details Integer only, so they run on the AVR without floating point and give bit-identical results when the
+         same code is compiled natively. Formats used below:
+         - Q15   int16_t, 1 sign bit and 15 fraction bits, -1.0 to just below 1.0
+         - Q14   int16_t coefficients from -2.0 to just below 2.0
+         - Q7    int8_t samples, or int16_t samples within +/-128
+         - phase uint16_t, one full turn is 65536
+*/
+
+/*
+@brief Sine from a quarter wave table with linear interpolation
+@param _phase Angle, 65536 per turn
+@return sin(_phase) in Q15
+*/
+int16_t dspSin(uint16_t _phase);
+
+/*
+@brief Cosine, see dspSin()
+*/
+inline int16_t dspCos(uint16_t _phase) {
+  return dspSin(_phase + 0x4000);
+}
+
+/*
+@brief Phase of a frequency at a sample rate, 65536 per turn
+*/
+uint16_t dspPhase(uint32_t _frequency, uint32_t _sampleRate);
+
+/*
+@brief Integer square root
+@return floor(sqrt(_value))
+*/
+uint16_t dspSqrt(uint32_t _value);
+
+/*
+@brief Exponentially weighted moving average, average += (value - average) / 2^shift
+*/
+inline int16_t dspEwma(int16_t _average, int16_t _value, uint8_t _shift) {
+  return _average + (int16_t)(((int32_t)_value - _average) >> _shift);
+}
+
+/*
+@brief Exponentially weighted moving average of unsigned 32-bit values
+*/
+inline uint32_t dspEwma32(uint32_t _average, uint32_t _value, uint8_t _shift) {
+  return _value >= _average ? _average + ((_value - _average) >> _shift) : _average - ((_average - _value) >> _shift);
+}
+
+// Goertzel filter for one frequency bin
+struct DspGoertzel {
+  int16_t coefficient;                                // 2 cos(2 pi k / N) in Q14
+  int16_t s1;
+  int16_t s2;
+};
+
+/*
+@brief Tune a Goertzel filter
+@param _phase Bin angle per sample, 2 pi k / N as a phase, see dspPhase()
+*/
+void dspGoertzelInit(DspGoertzel& _filter, uint16_t _phase);
+
+/*
+@brief Feed one Q7 sample into a Goertzel filter
+@note Keep samples within +/-128 and blocks short enough (N * 128 / sin(2 pi k / N) below 32768) for the state to fit.
+*/
+inline void dspGoertzelUpdate(DspGoertzel& _filter, int16_t _sample) {
+  int16_t s0 = _sample + (int16_t)(((int32_t)_filter.coefficient * _filter.s1) >> 14) - _filter.s2;
+  _filter.s2 = _filter.s1;
+  _filter.s1 = s0;
+}
+
+/*
+@brief Power of the bin after a block of samples, and reset the filter for the next block
+*/
+uint32_t dspGoertzelPower(DspGoertzel& _filter);
+
+// Second order IIR section, direct form I
+struct DspBiquad {
+  int16_t b0, b1, b2;                                 // Feed forward coefficients in Q14
+  int16_t a1, a2;                                     // Feedback coefficients in Q14, a0 is 1
+  int16_t x1, x2;                                     // Previous inputs
+  int16_t y1, y2;                                     // Previous outputs
+};
+
+/*
+@brief Design a band pass biquad with 0 dB peak gain
+@param _phase Centre frequency as a phase, see dspPhase()
+@param _q Quality factor, bandwidth is the centre frequency divided by _q
+*/
+void dspBiquadBandpass(DspBiquad& _filter, uint16_t _phase, uint8_t _q);
+
+/*
+@brief Filter one Q15 sample
+@return Filtered sample, saturated to Q15
+*/
+int16_t dspBiquad(DspBiquad& _filter, int16_t _sample);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef DSP_BENCHMARK_H
+#define DSP_BENCHMARK_H
+
+/*
+@brief Check and time the fixed-point DSP kernels on the device
+@details Every workload of dsp_workload.h is run and the checksum of its outputs is compared with the value the native
+         test suite asserts, so any difference between the AVR and the host shows up as FAIL. The time per call is
+         printed in CPU cycles, with the cost of generating the input subtracted.
+*/
+void dspBenchmarkRun();
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef DSP_WORKLOAD_H
+#define DSP_WORKLOAD_H
+
+#include <stdint.h>
+
+/*
+@brief Seeded workloads for the DSP kernels with the checksums of their outputs
+@details Every workload runs one kernel DSP_WORKLOAD_ITERATIONS times on the same pseudo-random input and returns a
+         checksum of everything the kernel produced. The native test suite test/test_dsp checks the checksums on the
+         host and dspBenchmarkRun() checks them again on the AVR, so the two builds are known to agree bit for bit.
+*/
+
+const uint16_t DSP_WORKLOAD_ITERATIONS = 1000;
+
+struct DspWorkload {
+  const char* name;
+  uint32_t (*run)();                                  // Returns the checksum of the kernel outputs
+  uint32_t expected;                                  // Checksum asserted by test/test_dsp
+};
+
+extern const DspWorkload dspWorkloads[];
+extern const uint8_t dspWorkloadCount;
+
+/*
+@brief Restart the pseudo-random input, call before every run
+*/
+void dspWorkloadReset();
+
+/*
+@brief Generate the input and checksum it without running a kernel, to measure the workload overhead
+*/
+uint32_t dspWorkloadOverhead();
+
+#endif
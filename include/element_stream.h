@@ -0,0 +1,71 @@
+#ifndef ELEMENT_STREAM_H
+#define ELEMENT_STREAM_H
+
+#include <stdint.h>
+
+/*
+@brief Bit packed element streams for FRAME_ELEMENTS frames
+@details A stream is a varint item count followed by the items packed four to a byte, least significant bits
+         first. Each item is two bits: the low bit is dot/dash and the high bit marks a gap, so decoding an item
+         is a single shift and mask with no branches.
+*/
+
+const uint8_t ELEMENT_DOT = 0;                        // 00
+const uint8_t ELEMENT_DASH = 1;                       // 01
+const uint8_t ELEMENT_CHARACTER_GAP = 2;              // 10  Gap between characters
+const uint8_t ELEMENT_WORD_GAP = 3;                   // 11  Gap between words
+
+const uint8_t VARINT_MAX_SIZE = 3;                    // Bytes needed for any uint16_t
+
+struct ElementStream {
+  uint8_t* bits;                                      // Packed items
+  uint8_t size;                                       // Size of bits in bytes
+  uint16_t count;                                     // Number of items in bits
+};
+
+/*
+@brief Write an unsigned LEB128 varint
+@return Number of bytes written, at most VARINT_MAX_SIZE
+*/
+uint8_t varintEncode(uint16_t _value, uint8_t* _out);
+
+/*
+@brief Read an unsigned LEB128 varint
+@return Number of bytes read, 0 if the data ends early or the value does not fit in 16 bits
+*/
+uint8_t varintDecode(const uint8_t* _data, uint8_t _length, uint16_t* _value);
+
+/*
+@brief Attach an empty stream to a buffer
+*/
+void elementStreamInit(ElementStream& _stream, uint8_t* _bits, uint8_t _size);
+
+/*
+@brief Append one item to a stream
+@return False if the buffer is full
+*/
+bool elementStreamAppend(ElementStream& _stream, uint8_t _item);
+
+/*
+@brief Read item _index of the packed bits
+*/
+inline uint8_t elementStreamItem(const uint8_t* _bits, uint16_t _index) {
+  return (_bits[_index >> 2] >> ((_index & 3) << 1)) & 3;
+}
+
+/*
+@brief Serialize a stream as a varint count followed by the packed bits
+@return Number of bytes written, 0 if _out is too small
+*/
+uint8_t elementStreamEncode(const ElementStream& _stream, uint8_t* _out, uint8_t _outSize);
+
+/*
+@brief Parse serialized stream data in place
+@param _data Serialized stream
+@param _length Number of bytes in _data
+@param _bits Receives a pointer to the packed bits inside _data
+@return Number of items, 0 if the data is malformed
+*/
+uint16_t elementStreamDecode(const uint8_t* _data, uint8_t _length, const uint8_t** _bits);
+
+#endif
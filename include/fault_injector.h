@@ -0,0 +1,63 @@
+#ifndef FAULT_INJECTOR_H
+#define FAULT_INJECTOR_H
+
+#include <stdint.h>
+
+/*
+@brief Seeded fault injection for bytes sent over the radio link
+@details Every write to the radio is one burst of bytes, e.g. a frame or an element line. faultApply() copies a
+         burst and damages it on the way: single bytes are dropped, bit flipped, duplicated or swapped with the next
+         byte, the burst can be cut short, and a two-state (Gilbert-Elliott) model drops runs of bytes to imitate
+         fades. The same seed and configuration always damage the same bytes, so a failure can be replayed.
+@note Rates are probabilities in 1/65536 per byte, or per burst for truncation.
+*/
+
+const uint16_t FAULT_RATE_PERCENT = 655;              // Multiply by a percentage to get a rate
+
+struct FaultConfig {
+  uint16_t dropRate;                                  // Byte is lost
+  uint16_t flipRate;                                  // One bit of the byte is inverted
+  uint16_t duplicateRate;                             // Byte arrives twice
+  uint16_t reorderRate;                               // Byte arrives after the next byte
+  uint16_t truncateRate;                              // Burst ends at a random byte
+  uint16_t burstEnterRate;                            // Link goes into a fade before this byte
+  uint16_t burstExitRate;                             // Link comes out of a fade before this byte
+};
+
+struct FaultStats {
+  uint32_t bytesIn;                                   // Bytes offered to faultApply()
+  uint32_t bytesOut;                                  // Bytes it passed on
+  uint32_t dropped;                                   // Single bytes dropped
+  uint32_t flipped;
+  uint32_t duplicated;
+  uint32_t reordered;
+  uint32_t truncated;                                 // Bursts cut short
+  uint32_t fadeDropped;                               // Bytes lost in fades
+};
+
+struct FaultInjector {
+  FaultConfig config;
+  FaultStats stats;
+  uint32_t random;                                    // xorshift32 state, never 0
+  bool fading;                                        // True while the link is in a fade
+};
+
+/*
+@brief Reset an injector to a configuration and seed, clearing its statistics
+*/
+void faultInit(FaultInjector& _injector, const FaultConfig& _config, uint32_t _seed);
+
+/*
+@brief Scale a configuration so its per byte rates add up to about _percent
+@details Drops, flips, duplicates and reorders share the rate equally, truncation and fades get a quarter each.
+*/
+FaultConfig faultConfigForRate(uint8_t _percent);
+
+/*
+@brief Copy a burst of bytes, injecting faults on the way
+@param _out Receives the damaged burst, needs room for 2 * _length bytes
+@return Number of bytes written to _out
+*/
+uint16_t faultApply(FaultInjector& _injector, const uint8_t* _data, uint16_t _length, uint8_t* _out);
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef FEATURE_FLAGS_H
+#define FEATURE_FLAGS_H
+
+/*
+@brief Build flags for the optional features that need RAM of their own
+@details The ATmega328P has 2 KB of SRAM, so the buffers of these features are only compiled in when their flag is
+         1. Add e.g. -D LOOPBACK_TEST=1 to an env's build_flags in platformio.ini. Settings that cost no RAM stay
+         const bool at the top of main.cpp.
+*/
+
+#ifndef LOOPBACK_TEST
+#define LOOPBACK_TEST 0                               // Receive everything this unit sends through a simulated link
+#endif
+
+#ifndef RADIO_TRACE
+#define RADIO_TRACE 0                                 // Keep the latest radio events for the trace command, see trace.h
+#endif
+
+#ifndef TONE_INPUT
+#define TONE_INPUT 0                                  // Key from a tone on TONE_INPUT_PIN as well as from the button
+#endif
+
+#ifndef FREQUENCY_HOPPING
+#define FREQUENCY_HOPPING 0                           // Hop channels on a schedule shared with the other device
+#endif
+
+#ifndef SECURE_FRAMES
+#define SECURE_FRAMES 0                               // Encrypt and authenticate everything sent via HC-12
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+
+/*
+@brief Binary frames sent over the HC-12 next to the "1"/"2" element lines
+@details A frame is FRAME_START, type, payload length, payload and a CRC-8 over type, length and payload.
+         FRAME_START is not a printable character, so the receiver can tell frames and element lines apart from the
+         first byte.
+*/
+
+const uint8_t FRAME_START = 0x02;                     // First byte of every frame (ASCII STX)
+const uint8_t FRAME_MAX_PAYLOAD = 32;                 // Largest payload of a message
+const uint8_t FRAME_SECURE_OVERHEAD = 9;              // Counter, inner type and tag a FRAME_SECURE adds, see secure_frame.h
+const uint8_t FRAME_MAX_WIRE_PAYLOAD = FRAME_MAX_PAYLOAD + FRAME_SECURE_OVERHEAD; // Largest payload accepted by the parser
+const uint8_t FRAME_OVERHEAD = 4;                     // Start, type, length and CRC bytes
+const uint8_t FRAME_MAX_SIZE = FRAME_MAX_WIRE_PAYLOAD + FRAME_OVERHEAD;
+
+const uint8_t FRAME_TEXT = 'T';                       // Payload is compressed text, see text_compress.h
+const uint8_t FRAME_ELEMENTS = 'E';                   // Payload is a bit packed element stream, see element_stream.h
+const uint8_t FRAME_BENCHMARK = 'B';                  // Payload controls a throughput benchmark, see main.cpp
+const uint8_t FRAME_CREDIT = 'C';                     // Payload advertises free playback space, see main.cpp
+const uint8_t FRAME_HOP = 'H';                        // Payload is a frequency hopping beacon, see main.cpp
+const uint8_t FRAME_SECURE = 'S';                     // Payload is another frame, encrypted and authenticated, see secure_frame.h
+const uint8_t FRAME_LINE = 'L';                       // Only inside FRAME_SECURE: payload is an element line without line end
+const uint8_t FRAME_COUNTER = 'N';                    // Only inside FRAME_SECURE: payload is the lowest counter the sender accepts
+
+const int8_t FRAME_INCOMPLETE = 0;                    // More bytes are needed
+const int8_t FRAME_COMPLETE = 1;                      // A valid frame is ready
+const int8_t FRAME_ERROR = -1;                        // The frame was damaged and has been dropped
+
+struct Frame {
+  uint8_t type;
+  uint8_t length;
+  uint8_t payload[FRAME_MAX_WIRE_PAYLOAD];
+};
+
+// Receive state, one per input stream
+struct FrameParser {
+  uint8_t state;
+  uint8_t index;
+  uint8_t crc;
+  Frame frame;
+};
+
+/*
+@brief Update a CRC-8 (polynomial 0x07) with one byte
+*/
+uint8_t frameCrc8(uint8_t _crc, uint8_t _byte);
+
+/*
+@brief Build a frame ready to be written to the HC-12
+@param _type Frame type
+@param _payload Payload bytes
+@param _length Payload length, at most FRAME_MAX_WIRE_PAYLOAD
+@param _out Receives the frame, at least FRAME_MAX_SIZE bytes
+@return Number of bytes written to _out, 0 if the payload is too long
+*/
+uint8_t frameEncode(uint8_t _type, const uint8_t* _payload, uint8_t _length, uint8_t* _out);
+
+/*
+@brief Reset a parser to wait for the next FRAME_START
+*/
+void frameParserReset(FrameParser& _parser);
+
+/*
+@brief Check if a parser is in the middle of a frame
+*/
+bool frameParserBusy(const FrameParser& _parser);
+
+/*
+@brief Feed one received byte into a parser
+@return FRAME_COMPLETE when _parser.frame holds a valid frame, FRAME_ERROR on a damaged frame, else FRAME_INCOMPLETE
+*/
+int8_t frameParserFeed(FrameParser& _parser, uint8_t _byte);
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#include <stdint.h>
+
+/*
+@brief Gesture recognizer for runtime control from the Morse key
+@details Holding the key past GESTURE_HOLD_DURATION enters command mode. While in command mode every press is
+         collected into a command letter which is committed after GESTURE_COMMIT_GAP of silence. Another very long
+         hold, or GESTURE_IDLE_TIMEOUT without input, leaves command mode again.
+@note The recognizer only looks at press durations that talkMorse() already measured, so normal elements are sent
+      as soon as they are released and never wait on it.
+@note Command letters are packed Morse codes: a leading 1 bit followed by one bit per element (0 = dot, 1 = dash),
+      at most 6 elements long.
+*/
+
+const unsigned long GESTURE_HOLD_DURATION = 3000;     // Press longer than this (ms) to enter or leave command mode
+const unsigned long GESTURE_COMMIT_GAP = 1500;        // Silence (ms) after the last element that completes a command
+const unsigned long GESTURE_IDLE_TIMEOUT = 15000;     // Command mode is left after this long (ms) without a command
+
+const uint8_t GESTURE_NONE = 0;                       // Nothing to do
+const uint8_t GESTURE_EXIT = 1;                       // Command mode was left (empty packed code)
+const uint8_t GESTURE_ENTER = 0xFF;                   // Command mode was entered (not a valid packed code)
+const uint8_t GESTURE_INVALID = 0xFE;                 // More elements were keyed than any command has
+
+const uint8_t GESTURE_CMD_STATS = 0b1000;             // S  ...   Dump statistics to the serial monitor
+const uint8_t GESTURE_CMD_WPM_UP = 0b1001;            // U  ..-   Faster playback
+const uint8_t GESTURE_CMD_WPM_DOWN = 0b1100;          // D  -..   Slower playback
+const uint8_t GESTURE_CMD_LINK = 0b10100;             // L  .-..  Switch to the next HC-12 link profile
+const uint8_t GESTURE_CMD_SEND_MODE = 0b111;          // M  --    Switch to the next send mode
+const uint8_t GESTURE_CMD_BENCHMARK = 0b11000;        // B  -...  Measure link throughput at every link profile
+
+/*
+@brief Check if the recognizer is in command mode
+@return True while key presses are consumed as commands
+*/
+bool gestureActive();
+
+/*
+@brief Feed one completed key press into the recognizer
+@param _pressDuration Measured press duration in milliseconds
+@param _isDash True if the press was classified as a dash
+@param _now Timestamp of the release in milliseconds
+@return True if the press was consumed by the recognizer and must not be sent as an element
+*/
+bool gestureOnPress(unsigned long _pressDuration, bool _isDash, unsigned long _now);
+
+/*
+@brief Advance the recognizer timers, call once per loop
+@param _now Current time in milliseconds
+@return GESTURE_NONE, GESTURE_ENTER, GESTURE_EXIT, GESTURE_INVALID or the packed code of a completed command letter
+*/
+uint8_t gesturePoll(unsigned long _now);
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef HOP_SCHEDULE_H
+#define HOP_SCHEDULE_H
+
+#include <stdint.h>
+
+/*
+@brief Shared frequency hopping schedule with per-channel loss statistics
+@details Time is divided into numbered slots and both devices tune to hopChannel() of the current slot. Every cycle
+         visits each usable channel once, in an order shuffled from the shared seed and the cycle number, so two
+         devices with the same seed, channel list and skip mask agree on every slot without talking about it.
+@details Each device counts the beacons it expected and lost per channel. A channel that loses at least
+         HOP_BAD_LOSS_PERCENT of a window of HOP_STATS_WINDOW beacons is marked bad and skipped for
+         HOP_PROBATION_SLOTS slots before it is tried again. Which channels the schedule skips is decided by one device
+         from the bad channels of both, see hopProposeSkipMask(), and announced to the other ahead of time.
+*/
+
+const uint8_t HOP_MAX_CHANNELS = 16;                  // Longest channel list, one bit each in the masks
+const uint8_t HOP_MIN_CHANNELS = 2;                   // Channels are only skipped while at least this many remain
+const uint8_t HOP_STATS_WINDOW = 8;                   // Expected beacons per channel before its loss is judged
+const uint8_t HOP_BAD_LOSS_PERCENT = 50;              // Loss at which a channel is marked bad
+const uint16_t HOP_PROBATION_SLOTS = 256;             // Slots a bad channel is skipped before it is tried again
+
+struct HopSchedule {
+  uint32_t seed;                                      // Shared by both devices
+  uint8_t channels[HOP_MAX_CHANNELS];                 // HC-12 channels, same order on both devices
+  uint8_t count;
+  uint16_t badMask;                                   // Channels this device measured as bad
+  uint16_t skipMask;                                  // Channels left out of the schedule
+  uint8_t expected[HOP_MAX_CHANNELS];                 // Beacons expected in the current window
+  uint8_t lost[HOP_MAX_CHANNELS];                     // Of those, beacons that did not arrive
+  uint16_t probation[HOP_MAX_CHANNELS];               // Slots until a bad channel is tried again
+  uint32_t totalExpected[HOP_MAX_CHANNELS];           // For the statistics
+  uint32_t totalLost[HOP_MAX_CHANNELS];
+};
+
+/*
+@brief Set up a schedule with no channel marked bad
+@param _channels HC-12 channels, at most HOP_MAX_CHANNELS
+*/
+void hopInit(HopSchedule& _schedule, uint32_t _seed, const uint8_t* _channels, uint8_t _count);
+
+/*
+@brief Index into channels of the channel to use in a slot
+*/
+uint8_t hopChannelIndex(const HopSchedule& _schedule, uint32_t _slot);
+
+/*
+@brief Channel to use in a slot
+*/
+uint8_t hopChannel(const HopSchedule& _schedule, uint32_t _slot);
+
+/*
+@brief Count whether the beacon expected in a slot arrived, call once at the end of every slot
+@param _index Channel index the slot was on
+@param _expected True if a beacon was expected, i.e. the other device is known to be hopping along
+@param _received True if it arrived
+@return True if the channel was just marked bad
+*/
+bool hopRecord(HopSchedule& _schedule, uint8_t _index, bool _expected, bool _received);
+
+/*
+@brief Channels to skip given the bad channels of both devices
+@param _peerMask Channels the other device measured as bad
+@return Mask of channels to skip, 0 if skipping them would leave fewer than HOP_MIN_CHANNELS
+*/
+uint16_t hopProposeSkipMask(const HopSchedule& _schedule, uint16_t _peerMask);
+
+/*
+@brief Change the channels the schedule skips, both devices must do so from the same slot on
+*/
+void hopSetSkipMask(HopSchedule& _schedule, uint16_t _skipMask);
+
+/*
+@brief Number of channels the schedule hops over
+*/
+uint8_t hopUsableChannels(const HopSchedule& _schedule);
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef KEY_SCRIPT_H
+#define KEY_SCRIPT_H
+
+#include <stdint.h>
+
+/*
+@brief Scripted key input that stands in for the button
+@details A script is a list of durations in milliseconds that alternate between key down and key up, starting with
+         key down. Each duration is counted from the moment the previous edge was observed through keyScriptDown(),
+         not from the start of the script, so a loop that is busy playing back received Morse delays the script
+         instead of shortening presses. The same script therefore produces the same press durations every run.
+@details Scripts come from a flash table or from text lines of space separated durations, e.g. "600 600 1800 1800",
+         fed one byte at a time from the serial monitor. A new script replaces the running one.
+*/
+
+const uint8_t KEY_SCRIPT_MAX_EDGES = 32;              // Longest script that can be received as text
+
+/*
+@brief Start a script stored in flash
+@param _script Durations in flash (PROGMEM)
+@param _count Number of durations, an odd count ends with the key held down until the script is stopped
+@param _repeat True to start over after the last duration
+*/
+void keyScriptStart(const uint16_t* _script, uint8_t _count, bool _repeat);
+
+/*
+@brief Stop the running script, the key is released
+*/
+void keyScriptStop();
+
+/*
+@brief Check if a script is running
+*/
+bool keyScriptActive();
+
+/*
+@brief Feed one byte of a text script
+@details A line of durations starts the script once its '\n' arrives. Anything other than digits and spaces, or
+         more than KEY_SCRIPT_MAX_EDGES durations, discards the line.
+@return True if the byte completed a line and the script was started
+*/
+bool keyScriptFeed(uint8_t _byte);
+
+/*
+@brief Read the scripted key
+@param _now Current time in milliseconds
+@return True while the key is down
+*/
+bool keyScriptDown(unsigned long _now);
+
+#endif
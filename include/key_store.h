@@ -0,0 +1,52 @@
+#ifndef KEY_STORE_H
+#define KEY_STORE_H
+
+#include <Arduino.h>
+#include "secure_frame.h"
+
+/*
+@brief Pre-shared link key and message counters in EEPROM
+@details The key is written once with keyStoreSave(), e.g. from a provisioning build, so it does not have to stay in
+         the firmware. Next to it are the send counter reserved so far, which a device never goes below after a
+         reset so no counter is used twice under the key, and the lowest counter still accepted from the other
+         device, so recorded frames cannot be replayed after a reset either. Both are written in batches by the
+         caller, not for every frame, to spare the EEPROM, see replayFloorAfter() and replayReserve().
+*/
+
+const int KEY_STORE_ADDRESS = 0;                      // Marker byte, key, send counter, receive floor
+const uint8_t KEY_STORE_MARKER = 0xA5;                // Written with the key, tells a stored key from erased EEPROM
+
+/*
+@brief Read the link key
+@param _key Receives SECURE_KEY_SIZE bytes
+@return False if no key was stored
+*/
+bool keyStoreLoad(uint8_t* _key);
+
+/*
+@brief Store the link key and start both counters over
+@param _key SECURE_KEY_SIZE bytes
+*/
+void keyStoreSave(const uint8_t* _key);
+
+/*
+@brief Send counter reserved so far, counting may resume from it
+*/
+uint32_t keyStoreSendCounter();
+
+/*
+@brief Reserve send counters up to a new value
+*/
+void keyStoreSaveSendCounter(uint32_t _counter);
+
+/*
+@brief Lowest counter accepted from the other device
+*/
+uint32_t keyStoreReceiveFloor();
+
+/*
+@brief Raise the lowest counter accepted from the other device
+*/
+void keyStoreSaveReceiveFloor(uint32_t _floor);
+
+#endif
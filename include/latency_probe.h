@@ -0,0 +1,56 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+/*
+@brief Marker pins for measuring end-to-end latency with a logic analyzer
+@details Every stage a key press passes on its way to the remote sounder toggles its own pin, so the analyzer shows
+         one edge per event on both units. A toggle is one write of the bit to the PINx register (a single sbi/out
+         instruction), which keeps the markers from disturbing the timing they measure.
+@details Build with -D LATENCY_PROBE=1 (see platformio.ini) to enable them. Otherwise every marker compiles to
+         nothing and the pins are left alone.
+
+Stage                      Pin
+Key edge detected          A2  PC2   Press and release
+Message queued             A3  PC3   Element line or frame handed to the radio path
+First byte written         A4  PC4   Just before the first byte goes to the HC-12
+First byte received        A5  PC5   First byte of a line or frame from the HC-12
+Message parsed             D3  PD3   Element line or frame complete
+Sounder on                 D5  PD5   Start of each received element
+*/
+
+#ifndef LATENCY_PROBE
+#define LATENCY_PROBE 0
+#endif
+
+#if LATENCY_PROBE && defined(__AVR__)
+#include <avr/io.h>
+
+#define PROBE_KEY_EDGE() (PINC = _BV(PINC2))
+#define PROBE_QUEUED() (PINC = _BV(PINC3))
+#define PROBE_TX_FIRST_BYTE() (PINC = _BV(PINC4))
+#define PROBE_RX_FIRST_BYTE() (PINC = _BV(PINC5))
+#define PROBE_PARSED() (PIND = _BV(PIND3))
+#define PROBE_SOUNDER_ON() (PIND = _BV(PIND5))
+
+/*
+@brief Make the marker pins outputs, all low
+*/
+inline void latencyProbeBegin() {
+  PORTC &= ~(_BV(PORTC2) | _BV(PORTC3) | _BV(PORTC4) | _BV(PORTC5));
+  PORTD &= ~(_BV(PORTD3) | _BV(PORTD5));
+  DDRC |= _BV(DDC2) | _BV(DDC3) | _BV(DDC4) | _BV(DDC5);
+  DDRD |= _BV(DDD3) | _BV(DDD5);
+}
+#else
+#define PROBE_KEY_EDGE() ((void)0)
+#define PROBE_QUEUED() ((void)0)
+#define PROBE_TX_FIRST_BYTE() ((void)0)
+#define PROBE_RX_FIRST_BYTE() ((void)0)
+#define PROBE_PARSED() ((void)0)
+#define PROBE_SOUNDER_ON() ((void)0)
+
+inline void latencyProbeBegin() {
+}
+#endif
+
+#endif
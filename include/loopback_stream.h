@@ -0,0 +1,58 @@
+#ifndef LOOPBACK_STREAM_H
+#define LOOPBACK_STREAM_H
+
+#include <Arduino.h>
+
+/*
+@brief Stream that receives what it sends, standing in for a pair of HC-12 modules
+@details Bytes written are delivered back to the reader at the pace of a serial link: the first byte of a burst
+         after the air latency plus one byte time, every following byte one byte time after the previous one.
+         Writing blocks for one byte time per byte, as SoftwareSerial does. This lets one unit run its sender and
+         receiver path against each other with the byte timing of the link. Nothing about the radio itself is
+         modelled: every byte arrives, in order, after the same air latency.
+*/
+class LoopbackStream : public Stream {
+public:
+  static const uint8_t BUFFER_SIZE = 64;              // Same as the SoftwareSerial receive buffer
+
+  /*
+  @param _baudRate Serial rate of the simulated link
+  @param _airLatency Delay from the end of the first byte to its delivery in microseconds
+  */
+  LoopbackStream(unsigned long _baudRate, unsigned long _airLatency);
+
+  /*
+  @brief Change the serial rate of the simulated link, like SoftwareSerial::begin()
+  */
+  void begin(unsigned long _baudRate);
+
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t _byte);
+  void flush();
+  using Print::write;
+
+  /*
+  @brief Number of bytes dropped because the buffer was full
+  */
+  unsigned long overflows() const;
+
+  /*
+  @brief Number of bytes written that were not read yet, including those still in flight
+  */
+  uint8_t pending() const;
+
+private:
+  uint8_t buffer[BUFFER_SIZE];
+  uint8_t head;                                       // Next byte to read
+  uint8_t count;                                      // Bytes in the buffer
+  unsigned long byteTime;                             // Microseconds per byte on the simulated link
+  unsigned long airLatency;
+  unsigned long headReadyTime;                        // micros() at which the head byte is delivered
+  unsigned long overflowCount;
+
+  bool headReady();
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef MORSE_CODEC_H
+#define MORSE_CODEC_H
+
+#include <stdint.h>
+
+/*
+@brief Morse character codec with prosigns
+@details Characters are handled as packed codes: a leading 1 bit followed by one bit per element (0 = dot,
+         1 = dash), so "E" is 0b10 and "U" is 0b1001. Packed codes are at most 6 elements long.
+         Decoding walks the Morse tree, which is stored as a flash table indexed directly by the packed code.
+@details A symbol is one byte: an uppercase ASCII character or a prosign token (MORSE_AR...MORSE_VE). Prosigns
+         therefore cost a single byte on air.
+*/
+
+const uint8_t MORSE_EMPTY_CODE = 1;                   // Packed code of an empty element sequence
+const uint8_t MORSE_INVALID_CODE = 0;                 // Packed code of a sequence longer than any symbol
+const uint8_t MORSE_MAX_ELEMENTS = 6;                 // Longest element sequence of a symbol
+
+// Prosign tokens, the element sequence is keyed without a character gap
+const uint8_t MORSE_PROSIGN = 0x80;                   // First prosign token
+const uint8_t MORSE_AR = 0x80;                        // .-.-.   End of message, also "+"
+const uint8_t MORSE_AS = 0x81;                        // .-...   Wait, also "&"
+const uint8_t MORSE_BT = 0x82;                        // -...-   Break, also "="
+const uint8_t MORSE_CT = 0x83;                        // -.-.-   Start of message
+const uint8_t MORSE_KN = 0x84;                        // -.--.   Go ahead named station only, also "("
+const uint8_t MORSE_SK = 0x85;                        // ...-.-  End of contact
+const uint8_t MORSE_VE = 0x86;                        // ...-.   Understood
+const uint8_t MORSE_PROSIGN_COUNT = 7;
+
+/*
+@brief Append one element to a packed code
+@param _code Packed code so far, MORSE_EMPTY_CODE to start a new symbol
+@param _isDash True for a dash, false for a dot
+@return The extended packed code, MORSE_INVALID_CODE once the sequence is too long
+*/
+uint8_t morseAppendElement(uint8_t _code, bool _isDash);
+
+/*
+@brief Number of elements in a packed code
+*/
+uint8_t morseCodeLength(uint8_t _code);
+
+/*
+@brief Decode a packed code into a symbol
+@return Uppercase character or prosign token, 0 if the sequence is not a symbol
+*/
+uint8_t morseDecode(uint8_t _code);
+
+/*
+@brief Encode a character or prosign token into a packed code
+@param _symbol Character (lowercase is accepted) or prosign token
+@return Packed code, MORSE_INVALID_CODE if the symbol has no Morse representation
+*/
+uint8_t morseEncode(uint8_t _symbol);
+
+/*
+@brief Copy the name of a prosign token
+@param _token Prosign token
+@param _name Receives the zero terminated name, at least 3 bytes
+@return True if _token is a prosign token
+*/
+bool morseProsignName(uint8_t _token, char* _name);
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef MORSE_TIMING_H
+#define MORSE_TIMING_H
+
+#include <stdint.h>
+
+/*
+@brief Standard Morse timing derived from a speed in words per minute
+@details Durations follow the PARIS standard: a dot is one unit of 1200 / WPM milliseconds, a dash three units, and the
+         gaps between elements, characters and words one, three and seven units. With Farnsworth spacing the
+         characters keep the speed of _wpm while the character and word gaps are stretched, in the 3:7 ratio, until
+         the overall speed is _farnsworthWpm (ARRL formula).
+@details The dot/dash and gap thresholds used to classify keying sit halfway between the durations they separate,
+         so sender, receiver and classifier all agree on one table.
+*/
+
+struct MorseTiming {
+  uint16_t dot;                                       // Dot and gap between elements in milliseconds
+  uint16_t dash;                                      // Three dots
+  uint16_t characterGap;                              // Silence between characters, three dots without Farnsworth
+  uint16_t wordGap;                                   // Silence between words, seven dots without Farnsworth
+};
+
+/*
+@brief Fill a timing table
+@param _wpm Character speed in words per minute, at least 1
+@param _farnsworthWpm Overall speed with Farnsworth spacing, 0 or not below _wpm for standard spacing
+*/
+void morseTimingCompute(MorseTiming& _timing, uint8_t _wpm, uint8_t _farnsworthWpm);
+
+/*
+@brief Presses longer than this are dashes, halfway between a dot and a dash
+*/
+inline uint16_t morseDashThreshold(const MorseTiming& _timing) {
+  return (_timing.dot + _timing.dash) / 2;
+}
+
+/*
+@brief Presses this short or shorter are contact bounce, a quarter dot
+*/
+inline uint16_t morseGlitchThreshold(const MorseTiming& _timing) {
+  return _timing.dot / 4;
+}
+
+/*
+@brief Classify a press by its duration
+@return 1 for a dot, 2 for a dash, 0 for contact bounce
+*/
+inline uint8_t morseClassifyPress(const MorseTiming& _timing, unsigned long _duration) {
+  if (_duration <= morseGlitchThreshold(_timing)) {
+    return 0;
+  }
+  return _duration <= morseDashThreshold(_timing) ? 1 : 2;
+}
+
+/*
+@brief Silence longer than this ends a character, halfway between an element gap and a character gap
+*/
+inline uint16_t morseCharacterThreshold(const MorseTiming& _timing) {
+  return (_timing.dot + _timing.characterGap) / 2;
+}
+
+/*
+@brief Silence longer than this ends a word, halfway between a character gap and a word gap
+*/
+inline uint16_t morseWordThreshold(const MorseTiming& _timing) {
+  return (_timing.characterGap + _timing.wordGap) / 2;
+}
+
+#endif
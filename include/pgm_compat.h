@@ -0,0 +1,22 @@
+#ifndef PGM_COMPAT_H
+#define PGM_COMPAT_H
+
+/*
+@brief Flash access for tables shared between the firmware and native builds
+@details On AVR the tables live in flash and are read with pgm_read_*(). Other targets keep them in normal memory.
+*/
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#ifndef PROGMEM
+#define PROGMEM
+#define pgm_read_byte(_address) (*(const uint8_t*)(_address))
+#define pgm_read_word(_address) (*(const uint16_t*)(_address))
+#define memcpy_P memcpy
+#endif
+#endif
+
+#endif
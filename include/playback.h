@@ -0,0 +1,83 @@
+#ifndef PLAYBACK_H
+#define PLAYBACK_H
+
+#include <stdint.h>
+
+/*
+@brief Non-blocking playback of received Morse
+@details Received elements and gaps are queued as ELEMENT_* items (see element_stream.h), packed four to a byte, and
+         played by a state machine that is advanced from loop(). Receiving therefore never waits for the sounder, and
+         the free space of the queue is what the receiver can advertise as credit to the sender.
+@details Every phase is scheduled from the end of the previous one rather than from when it was noticed, so a busy
+         loop delays the sounder edges but does not stretch the rhythm.
+@details With speed-up enabled a deep queue plays faster: all durations of an item are scaled down in proportion to
+         the backlog when the item starts, and go back to normal as the queue clears.
+*/
+
+const uint16_t PLAYBACK_QUEUE_SIZE = 256;             // Items, enough for the longest word in a FRAME_TEXT frame
+
+const uint8_t PLAYBACK_NONE = 0;                      // Sounder unchanged
+const uint8_t PLAYBACK_ON = 1;                        // Sounder must be switched on, an element starts
+const uint8_t PLAYBACK_OFF = 2;                       // Sounder must be switched off
+
+struct PlaybackTiming {
+  uint16_t dot;                                       // Sounder on time of a dot in milliseconds
+  uint16_t dash;                                      // Sounder on time of a dash
+  uint16_t elementGap;                                // Silence after every element
+  uint16_t characterGap;                              // Silence added by ELEMENT_CHARACTER_GAP
+  uint16_t wordGap;                                   // Silence added by ELEMENT_WORD_GAP
+};
+
+/*
+@brief Empty the queue and stop playback
+*/
+void playbackReset();
+
+/*
+@brief Set the durations used for items that start from now on
+*/
+void playbackSetTiming(const PlaybackTiming& _timing);
+
+/*
+@brief Play faster while the queue is deep
+@param _startDepth Queued items at which speed-up starts
+@param _fullDepth Queued items at which durations reach _minPercent
+@param _minPercent Shortest duration in percent of the normal one, 100 disables speed-up
+@param _minDuration No duration is shortened below this many milliseconds
+*/
+void playbackSetSpeedup(uint16_t _startDepth, uint16_t _fullDepth, uint8_t _minPercent, uint16_t _minDuration);
+
+/*
+@brief Current duration scale in percent, 100 when playing at normal speed
+*/
+uint8_t playbackSpeedPercent();
+
+/*
+@brief Queue one ELEMENT_* item
+@return False if the queue is full and the item was dropped
+*/
+bool playbackPush(uint8_t _item);
+
+/*
+@brief Number of items waiting, not counting the one playing
+*/
+uint16_t playbackQueued();
+
+/*
+@brief Number of items that can still be queued
+*/
+uint16_t playbackFree();
+
+/*
+@brief Check if anything is playing or waiting
+*/
+bool playbackBusy();
+
+/*
+@brief Advance playback, call once per loop
+@param _now Current time in milliseconds
+@return PLAYBACK_NONE, PLAYBACK_ON or PLAYBACK_OFF
+*/
+uint8_t playbackUpdate(unsigned long _now);
+
+#endif
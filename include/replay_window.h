@@ -0,0 +1,61 @@
+#ifndef REPLAY_WINDOW_H
+#define REPLAY_WINDOW_H
+
+#include <stdint.h>
+
+/*
+@brief Sliding window of message counters already received from the other device
+@details The window remembers the highest counter accepted and, one bit each, which of the REPLAY_WINDOW_SIZE
+         counters below it were accepted too. A counter above the top, or inside the window and not seen yet, is
+         fresh; everything else is a replay or too old to tell. Checking is O(1), so replays are dropped before any
+         work is spent on them, and frames reordered by up to REPLAY_WINDOW_SIZE are still taken.
+*/
+
+const uint8_t REPLAY_WINDOW_SIZE = 32;                // Counters below the top that are still accepted out of order
+const uint32_t REPLAY_BATCH = 256;                    // Counters reserved or accepted per EEPROM write
+
+struct ReplayWindow {
+  uint32_t top;                                       // Highest counter accepted
+  uint32_t seen;                                      // Bit n set if top - n was accepted, bit 0 is top itself
+};
+
+/*
+@brief Start a window that only accepts counters from a floor up
+*/
+void replayInit(ReplayWindow& _window, uint32_t _floor);
+
+/*
+@brief Check if a counter is fresh, without changing the window
+*/
+bool replayCheck(const ReplayWindow& _window, uint32_t _counter);
+
+/*
+@brief Mark a counter as received, call only once the frame carrying it was authenticated
+*/
+void replayAccept(ReplayWindow& _window, uint32_t _counter);
+
+/*
+@brief Lowest counter above everything accepted so far
+*/
+uint32_t replayNext(const ReplayWindow& _window);
+
+/*
+@brief Receive floor to save once a counter was accepted, raised a whole batch at a time to spare the EEPROM
+@details After a reset the window starts from the saved floor, so the accepted counter and everything up to the end
+         of its batch is rejected from then on.
+@param _floor Floor saved so far
+@param _counter Counter just accepted
+@return New floor to save, _floor itself if the counter is below it and nothing has to be written
+*/
+uint32_t replayFloorAfter(uint32_t _floor, uint32_t _counter);
+
+/*
+@brief Send counters to reserve before sending one, a whole batch at a time to spare the EEPROM
+@details After a reset counting resumes from the saved reservation, so no counter is sent twice.
+@param _reserved Counters are reserved up to this one so far
+@param _next Counter about to be sent
+@return New reservation to save, _reserved itself if _next is below it and nothing has to be written
+*/
+uint32_t replayReserve(uint32_t _reserved, uint32_t _next);
+
+#endif
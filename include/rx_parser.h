@@ -0,0 +1,55 @@
+#ifndef RX_PARSER_H
+#define RX_PARSER_H
+
+#include <stdint.h>
+#include "frame.h"
+
+/*
+@brief Receive parser for everything that arrives from the HC-12
+@details Bytes are fed one at a time. A FRAME_START outside a frame begins a binary frame which is handed to the
+         frame parser, anything else is collected into an element line ending in '\n'. Element lines never contain a
+         FRAME_START, so after a damaged frame the parser is back in step at the start of the next one. Memory is fixed, no byte
+         is ever looked at twice and a partial line or frame simply waits for the next call, so any byte stream
+         costs bounded time and space.
+*/
+
+const uint8_t RX_LINE_MAX = 8;                        // Longest line kept, longer lines are reported as invalid
+
+const uint8_t RX_NONE = 0;                            // Nothing complete yet
+const uint8_t RX_ELEMENT = 1;                         // Element line, value in element
+const uint8_t RX_FRAME = 2;                           // Valid frame in frame.frame
+const uint8_t RX_FRAME_ERROR = 3;                     // Damaged frame was dropped
+const uint8_t RX_INVALID = 4;                         // Line that is not an element
+
+struct RxParser {
+  FrameParser frame;
+  char line[RX_LINE_MAX + 1];                         // Current line, NUL terminated, without the line ending
+  uint8_t lineLength;
+  bool lineOverflow;                                  // True if the current line was longer than RX_LINE_MAX
+  uint8_t element;                                    // 1 for dot, 2 for dash after RX_ELEMENT
+};
+
+/*
+@brief Clear the parser state
+*/
+void rxParserReset(RxParser& _parser);
+
+/*
+@brief Check if a line or frame is partially received
+*/
+bool rxParserBusy(const RxParser& _parser);
+
+/*
+@brief Feed one received byte
+@return RX_NONE or the event the byte completed
+@note After RX_ELEMENT and RX_INVALID, line holds the completed line until the next byte is fed.
+*/
+uint8_t rxParserFeed(RxParser& _parser, uint8_t _byte);
+
+/*
+@brief Check the parser invariants, used by the fuzz self-test
+@return False if any index is out of range
+*/
+bool rxParserValid(const RxParser& _parser);
+
+#endif
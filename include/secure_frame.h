@@ -0,0 +1,61 @@
+#ifndef SECURE_FRAME_H
+#define SECURE_FRAME_H
+
+#include <stdint.h>
+#include "frame.h"
+
+/*
+@brief Authenticated encryption of frames with a pre-shared key
+@details A sealed frame is carried as the payload of a FRAME_SECURE frame: a 32 bit message counter, the encrypted
+         type and payload of the inner frame, and a 32 bit tag. Encryption is CCM with the Speck64/128 block cipher:
+         a CBC-MAC over the length, counter and plaintext, then counter mode over the plaintext and tag. Speck was
+         chosen over XTEA for its speed on an 8 bit CPU, a block takes well under half the cycles.
+@details The counter is the nonce, it must never repeat under one key. Its top bit tells the two devices apart, so
+         they can count independently, and a device rejects frames carrying its own bit, i.e. its own frames sent
+         back to it.
+*/
+
+const uint8_t SECURE_KEY_SIZE = 16;                   // Pre-shared key in bytes
+const uint8_t SECURE_TAG_SIZE = 4;                    // Truncated tag, a forgery succeeds with probability 2^-32
+const uint8_t SPECK_ROUNDS = 27;                      // Rounds of Speck64/128
+const uint32_t SECURE_SENDER_BIT = 0x80000000UL;      // Counter bit that tells the two devices apart
+
+struct SecureKey {
+  uint32_t roundKeys[SPECK_ROUNDS];                   // Expanded once, 108 bytes
+};
+
+/*
+@brief Expand a key
+@param _key128 Pre-shared key, SECURE_KEY_SIZE bytes
+*/
+void secureKeyInit(SecureKey& _key, const uint8_t* _key128);
+
+/*
+@brief Encrypt one Speck64 block in place
+@param _block Two words, x in _block[1] and y in _block[0]
+*/
+void speckEncrypt(const SecureKey& _key, uint32_t* _block);
+
+/*
+@brief Seal a frame into the payload of a FRAME_SECURE frame
+@param _counter Message counter, a new one for every frame
+@param _type Type of the inner frame
+@param _payload Payload of the inner frame
+@param _length Length of the inner payload, at most FRAME_MAX_PAYLOAD
+@param _out Receives the sealed payload, at least _length + FRAME_SECURE_OVERHEAD bytes
+@return Number of bytes written to _out, 0 if the payload is too long
+*/
+uint8_t secureSeal(const SecureKey& _key, uint32_t _counter, uint8_t _type, const uint8_t* _payload, uint8_t _length,
+                   uint8_t* _out);
+
+/*
+@brief Check and decrypt the payload of a FRAME_SECURE frame
+@param _data Sealed payload
+@param _length Its length
+@param _counter Receives the message counter
+@param _inner Receives the inner frame, left undefined if the check fails
+@return True if the tag matched
+*/
+bool secureOpen(const SecureKey& _key, const uint8_t* _data, uint8_t _length, uint32_t* _counter, Frame& _inner);
+
+#endif
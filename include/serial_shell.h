@@ -0,0 +1,69 @@
+#ifndef SERIAL_SHELL_H
+#define SERIAL_SHELL_H
+
+#include <stdint.h>
+#include "frame.h"
+
+/*
+@brief Command parser for the USB serial port, with a text mode for people and a binary mode for tools
+@details Bytes are fed one at a time, as they arrive. A FRAME_START at the start of a line begins a binary request in
+         the frame format of frame.h, its type is the opcode and its payload the argument. Anything else is a text
+         line ending in '\n', a command name followed by its argument, e.g. "wpm 12". Both modes share the opcodes.
+         Memory is fixed and nothing waits for more bytes, so the radio path is never held up by a slow or
+         malformed request.
+*/
+
+const uint8_t SHELL_LINE_MAX = 40;                    // Longest text line kept, longer lines are reported as errors
+
+const uint8_t SHELL_NONE = 0;                         // Nothing complete yet
+const uint8_t SHELL_COMMAND = 1;                      // A request is ready in command
+const uint8_t SHELL_ERROR = 2;                        // Line too long, unknown command name or damaged binary request
+
+const uint8_t SHELL_OP_HELP = 'h';                    // help            List the commands
+const uint8_t SHELL_OP_STATS = 's';                   // stats           Statistics
+const uint8_t SHELL_OP_WPM = 'w';                     // wpm <n>         Set the playback speed
+const uint8_t SHELL_OP_LINK = 'l';                    // link <n>        Switch to a link profile
+const uint8_t SHELL_OP_AT = 'a';                      // at <command>    Send an AT command to the HC-12
+const uint8_t SHELL_OP_BRIDGE = 'b';                  // bridge          Pass the serial port through to the HC-12 in AT mode
+const uint8_t SHELL_OP_TRACE = 't';                   // trace           Dump the event trace
+const uint8_t SHELL_OP_KEY = 'k';                     // key <durations> Start a key script, see key_script.h
+
+const uint8_t SHELL_STATUS_OK = 0;                    // First payload byte of binary replies
+const uint8_t SHELL_STATUS_BAD_ARGUMENT = 1;
+const uint8_t SHELL_STATUS_BUSY = 2;                  // Try again later, e.g. an AT command is still running
+const uint8_t SHELL_STATUS_UNKNOWN = 3;               // Unknown opcode
+
+struct ShellCommand {
+  uint8_t opcode;
+  bool binary;                                        // True if the request came in binary mode and wants a binary reply
+  const uint8_t* argument;                            // Points into the parser, valid until the next byte is fed
+  uint8_t argumentLength;
+};
+
+struct ShellParser {
+  FrameParser frame;
+  char line[SHELL_LINE_MAX + 1];                      // Current text line, NUL terminated, without the line ending
+  uint8_t lineLength;
+  bool lineOverflow;                                  // True if the current line was longer than SHELL_LINE_MAX
+  ShellCommand command;                               // The request after SHELL_COMMAND
+};
+
+/*
+@brief Clear the parser state
+*/
+void shellReset(ShellParser& _parser);
+
+/*
+@brief Feed one byte from the serial port
+@return SHELL_NONE or the event the byte completed
+*/
+uint8_t shellFeed(ShellParser& _parser, uint8_t _byte);
+
+/*
+@brief Read a decimal number from a text argument
+@param _value Receives the number
+@return False if the argument is empty, not a number or larger than 65535
+*/
+bool shellNumber(const uint8_t* _argument, uint8_t _length, uint16_t* _value);
+
+#endif
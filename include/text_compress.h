@@ -0,0 +1,48 @@
+#ifndef TEXT_COMPRESS_H
+#define TEXT_COMPRESS_H
+
+#include <stdint.h>
+
+/*
+@brief Dictionary compression for the text carried in FRAME_TEXT frames
+@details Text is a sequence of Morse codec symbols with ' ' between words. Compressed text uses one byte per item:
+         - TEXT_WORD + index   a whole word from the flash word table
+         - ' ' to '_'          a literal character
+         - MORSE_PROSIGN...    a prosign token
+         - TEXT_ESCAPE, byte   any other byte, passed through literally
+         The word table is shared by all devices through the firmware, the index is what goes on air.
+*/
+
+const uint8_t TEXT_WORD = 0xA0;                       // Code of the first word table entry
+const uint8_t TEXT_ESCAPE = 0x1B;                     // Next byte is a literal (ASCII ESC)
+const uint8_t TEXT_MAX_WORD_LENGTH = 5;               // Longest word in the word table
+
+/*
+@brief Compress text
+@param _text Symbols to compress
+@param _length Number of symbols
+@param _out Receives the compressed text
+@param _outSize Size of _out in bytes
+@return Number of bytes written, 0 if _out is too small
+*/
+uint8_t textCompress(const uint8_t* _text, uint8_t _length, uint8_t* _out, uint8_t _outSize);
+
+/*
+@brief Expand compressed text
+@param _data Compressed text
+@param _length Number of compressed bytes
+@param _out Receives the symbols
+@param _outSize Size of _out in bytes
+@return Number of symbols written, 0 if the data is malformed or _out is too small
+*/
+uint8_t textExpand(const uint8_t* _data, uint8_t _length, uint8_t* _out, uint8_t _outSize);
+
+/*
+@brief Find a word in the word table
+@param _word Characters of the word, not zero terminated
+@param _length Number of characters in _word
+@return Index into the word table, -1 if the word is not in it
+*/
+int8_t textFindWord(const uint8_t* _word, uint8_t _length);
+
+#endif
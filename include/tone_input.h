@@ -0,0 +1,55 @@
+#ifndef TONE_INPUT_H
+#define TONE_INPUT_H
+
+#include <Arduino.h>
+#include "adc_sampler.h"
+
+/*
+@brief Audio Morse input from an analog pin
+@details The ADC sampler fills blocks of ADC_BLOCK_SIZE samples at TONE_SAMPLE_RATE in the background. Each block
+         is run through a fixed-point Goertzel filter tuned to the tone frequency from the main loop. The block
+         power is compared against an adaptive threshold halfway between the noise floor and the signal level,
+         and the mark/space state changes after TONE_DEBOUNCE_BLOCKS blocks agree. Completed marks are queued
+         with timestamps derived from the block sequence numbers, so they stay exact however late a block is
+         processed.
+@note All filter math is 16/32-bit integer. Uses Timer1 and the ADC exclusively while running.
+*/
+
+const uint16_t TONE_SAMPLE_RATE = 4000;               // Samples per second
+const uint8_t TONE_BLOCK_SIZE = ADC_BLOCK_SIZE;       // Samples per Goertzel block, 20 ms and 50 Hz bins at 4 kHz
+const uint8_t TONE_DEBOUNCE_BLOCKS = 2;               // Blocks that must agree before the mark/space state changes
+const uint8_t TONE_MARK_QUEUE_SIZE = 4;               // Completed marks buffered between polls
+
+/*
+@brief Start sampling and detecting a tone
+@param _analogPin Analog input with the audio, biased to mid supply
+@param _frequency Tone frequency in Hz, rounded to the nearest Goertzel bin
+*/
+void toneInputBegin(uint8_t _analogPin, uint16_t _frequency);
+
+/*
+@brief Stop sampling and release Timer1 and the ADC
+*/
+void toneInputEnd();
+
+/*
+@brief Current debounced state
+@return True while a tone is detected
+*/
+bool toneInputMark();
+
+/*
+@brief Process the sample blocks that are ready and take the oldest completed mark from the queue
+@param _start Receives the time the mark started in milliseconds
+@param _duration Receives the mark duration in milliseconds
+@return False if no mark has completed since the last call
+*/
+bool toneInputPoll(unsigned long* _start, unsigned long* _duration);
+
+/*
+@brief Tone power of the last block and the current detection threshold, for tuning
+*/
+uint32_t toneInputPower();
+uint32_t toneInputThreshold();
+
+#endif
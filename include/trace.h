@@ -0,0 +1,54 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include "feature_flags.h"
+
+/*
+@brief Ring buffer of the latest radio events, for dumping from the serial shell
+@details Recording an event is a few stores, cheap enough for the receive and send paths. Once TRACE_SIZE events
+         were recorded the oldest is overwritten.
+@details Only built with RADIO_TRACE, see feature_flags.h. Without it traceRecord() compiles to nothing.
+*/
+
+const uint8_t TRACE_SIZE = 32;                        // Events kept
+
+const uint8_t TRACE_TX = 'T';                         // Sent, detail is the frame type or the element line's first byte
+const uint8_t TRACE_RX = 'R';                         // Received, detail as for TRACE_TX
+const uint8_t TRACE_RX_ERROR = 'E';                   // Damaged frame dropped
+const uint8_t TRACE_REJECTED = 'X';                   // Dropped by SECURE_FRAMES, detail is 'R' for a replay
+const uint8_t TRACE_CHANNEL = 'C';                    // Switched channel, detail is the channel
+
+struct TraceEntry {
+  uint32_t time;                                      // Milliseconds since start
+  uint8_t event;
+  uint8_t detail;
+};
+
+#if RADIO_TRACE
+/*
+@brief Record an event
+*/
+void traceRecord(uint32_t _time, uint8_t _event, uint8_t _detail);
+
+/*
+@brief Number of events kept, at most TRACE_SIZE
+*/
+uint8_t traceCount();
+
+/*
+@brief Read a kept event
+@param _index 0 for the oldest, up to traceCount() - 1
+*/
+const TraceEntry& traceEntry(uint8_t _index);
+
+/*
+@brief Forget all events
+*/
+void traceClear();
+#else
+inline void traceRecord(uint32_t, uint8_t, uint8_t) {
+}
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+#include "adc_sampler.h"
+#include "feature_flags.h"
+
+#if TONE_INPUT
+static uint8_t blocks[2][ADC_BLOCK_SIZE];             // Ping-pong sample blocks
+static uint8_t fillBlock = 0;                         // Block the interrupt writes into
+static uint8_t sampleIndex = 0;
+static uint32_t fillSequence = 0;                     // Sequence number of the block being filled
+static volatile int8_t readyBlock = -1;               // Block handed to the main loop, -1 if none
+static volatile uint32_t readySequence = 0;
+static volatile uint16_t overruns = 0;
+
+ISR(ADC_vect) {
+  TIFR1 = (1 << OCF1B);                               // Clear the trigger flag so the next compare match starts a conversion
+  blocks[fillBlock][sampleIndex] = ADCH;
+
+  if (++sampleIndex >= ADC_BLOCK_SIZE) {
+    sampleIndex = 0;
+    if (readyBlock < 0) {                             // Hand over the block and continue in the other one
+      readyBlock = fillBlock;
+      readySequence = fillSequence;
+      fillBlock ^= 1;
+    } else {                                          // Main loop is still busy, this block is refilled
+      overruns++;
+    }
+    fillSequence++;
+  }
+}
+
+void adcSamplerBegin(uint8_t _analogPin, uint16_t _sampleRate) {
+  uint8_t channel = _analogPin >= A0 ? _analogPin - A0 : _analogPin;
+
+  noInterrupts();
+  fillBlock = 0;
+  sampleIndex = 0;
+  fillSequence = 0;
+  readyBlock = -1;
+  overruns = 0;
+
+  TCCR1A = 0;
+  TCCR1B = (1 << WGM12) | (1 << CS11);                // CTC mode, prescaler 8
+  TCNT1 = 0;
+  OCR1A = F_CPU / 8 / _sampleRate - 1;
+  OCR1B = OCR1A;                                      // Compare match B at the top of every period triggers the ADC
+  TIMSK1 = 0;
+
+  DIDR0 |= 1 << channel;                              // Digital input buffer off, less noise on the analog pin
+  ADMUX = (1 << REFS0) | (1 << ADLAR) | (channel & 0x07); // AVcc reference, left adjusted for 8-bit reads
+  ADCSRB = (1 << ADTS2) | (1 << ADTS0);               // Auto-trigger source Timer1 compare match B
+  ADCSRA = (1 << ADEN) | (1 << ADATE) | (1 << ADIE) | (1 << ADIF) | (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0); // 125 kHz ADC clock
+  interrupts();
+}
+
+void adcSamplerEnd() {
+  ADCSRA = 0;
+  ADCSRB = 0;
+  TCCR1B = 0;
+  readyBlock = -1;
+}
+
+const uint8_t* adcSamplerBlock(uint32_t* _sequence) {
+  int8_t block = readyBlock;
+  if (block < 0) {
+    return NULL;
+  }
+
+  noInterrupts();
+  *_sequence = readySequence;
+  interrupts();
+  return blocks[block];
+}
+
+void adcSamplerRelease() {
+  readyBlock = -1;
+}
+
+uint16_t adcSamplerOverruns() {
+  noInterrupts();
+  uint16_t value = overruns;
+  interrupts();
+  return value;
+}
+
+#endif
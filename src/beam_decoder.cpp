@@ -0,0 +1,190 @@
+#include "beam_decoder.h"
+#include "morse_codec.h"
+
+static const uint16_t SPLIT_PENALTY = 32;             // Extra cost of splitting a character, a lone long space is rare
+
+struct Candidate {
+  uint8_t first;                                      // Symbol completed by a character gap inside the marks, 0 if none
+  uint8_t code;                                       // Packed code of the marks after that gap
+  uint16_t cost;                                      // Accumulated timing error
+};
+
+static Candidate beam[BEAM_WIDTH];
+static uint8_t beamSize = 0;
+static uint16_t dotEstimate = 0;
+static uint16_t marks[BEAM_MAX_MARKS];                // Mark durations of the current character
+static uint8_t markCount = 0;
+static uint8_t prefixMask[16];                        // Bit per packed code below 128, set if it leads to a symbol
+
+/*
+@brief Check if a packed code is a symbol or the start of one
+*/
+static bool isPrefix(uint8_t _code) {
+  return _code < 128 && (prefixMask[_code >> 3] & (1 << (_code & 7)));
+}
+
+/*
+@brief Relative error of a duration against a multiple of the dot estimate, in 1/64 units
+*/
+static uint16_t timingCost(uint16_t _duration, uint8_t _dots) {
+  uint32_t ideal = (uint32_t)dotEstimate * _dots;
+  uint32_t error = _duration > ideal ? _duration - ideal : ideal - _duration;
+  uint32_t cost = (error << 6) / ideal;
+  return cost > 0x3FF ? 0x3FF : (uint16_t)cost;
+}
+
+/*
+@brief Insert a candidate into a beam sorted by cost, dropping the most expensive when full
+*/
+static void insertCandidate(Candidate* _beam, uint8_t& _size, uint8_t _first, uint8_t _code, uint16_t _cost) {
+  for (uint8_t i = 0; i < _size; i++) {
+    if (_beam[i].first == _first && _beam[i].code == _code) {
+      if (_beam[i].cost <= _cost) {
+        return;
+      }
+      for (uint8_t j = i; j + 1 < _size; j++) {     // Remove the worse duplicate, it is reinserted below
+        _beam[j] = _beam[j + 1];
+      }
+      _size--;
+      break;
+    }
+  }
+
+  uint8_t position = _size;
+  while (position > 0 && _beam[position - 1].cost > _cost) {
+    position--;
+  }
+  if (position >= BEAM_WIDTH) {
+    return;
+  }
+
+  uint8_t last = _size < BEAM_WIDTH ? _size : BEAM_WIDTH - 1;
+  for (uint8_t j = last; j > position; j--) {
+    _beam[j] = _beam[j - 1];
+  }
+  _beam[position].first = _first;
+  _beam[position].code = _code;
+  _beam[position].cost = _cost;
+  if (_size < BEAM_WIDTH) {
+    _size++;
+  }
+}
+
+void beamDecoderInit(uint16_t _dotDuration) {
+  dotEstimate = _dotDuration > 0 ? _dotDuration : 1;
+  beamSize = 1;
+  beam[0].first = 0;
+  beam[0].code = MORSE_EMPTY_CODE;
+  beam[0].cost = 0;
+  markCount = 0;
+
+  for (uint8_t i = 0; i < sizeof(prefixMask); i++) {
+    prefixMask[i] = 0;
+  }
+  for (uint8_t code = 127; code >= 1; code--) {      // Children first, a code leads somewhere if a child does
+    bool prefix = morseDecode(code) != 0 || (code < 64 && (isPrefix(code << 1) || isPrefix((code << 1) | 1)));
+    if (prefix) {
+      prefixMask[code >> 3] |= 1 << (code & 7);
+    }
+  }
+}
+
+void beamDecoderMark(uint16_t _duration, uint16_t _gapBefore) {
+  Candidate next[BEAM_WIDTH];
+  uint8_t nextSize = 0;
+
+  uint16_t dotCost = timingCost(_duration, 1);
+  uint16_t dashCost = timingCost(_duration, 3);
+  uint16_t joinCost = 0;
+  uint16_t splitCost = 0;
+  if (markCount > 0) {
+    joinCost = timingCost(_gapBefore, 1);
+    splitCost = timingCost(_gapBefore, 3) + SPLIT_PENALTY;
+  }
+
+  for (uint8_t i = 0; i < beamSize; i++) {
+    const Candidate& candidate = beam[i];
+
+    for (uint8_t split = 0; split < 2; split++) {
+      uint8_t first = candidate.first;
+      uint8_t code = candidate.code;
+      uint16_t cost = candidate.cost + joinCost;
+
+      if (split) {                                    // The space before this mark was a character gap
+        if (markCount == 0 || first != 0 || morseDecode(code) == 0) {
+          continue;
+        }
+        first = morseDecode(code);
+        code = MORSE_EMPTY_CODE;
+        cost = candidate.cost + splitCost;
+      }
+
+      uint8_t dot = morseAppendElement(code, false);
+      uint8_t dash = morseAppendElement(code, true);
+      if (isPrefix(dot)) {
+        insertCandidate(next, nextSize, first, dot, cost + dotCost);
+      }
+      if (isPrefix(dash)) {
+        insertCandidate(next, nextSize, first, dash, cost + dashCost);
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < nextSize; i++) {
+    beam[i] = next[i];
+  }
+  beamSize = nextSize;
+
+  if (markCount < BEAM_MAX_MARKS) {
+    marks[markCount] = _duration;
+  }
+  markCount++;
+}
+
+bool beamDecoderBusy() {
+  return markCount > 0;
+}
+
+uint8_t beamDecoderFinish(uint8_t* _symbols) {
+  uint8_t count = 0;
+
+  for (uint8_t i = 0; i < beamSize && count == 0; i++) {
+    uint8_t symbol = morseDecode(beam[i].code);
+    if (symbol == 0) {
+      continue;
+    }
+
+    // Learn the operator's speed from the marks of the chosen interpretation
+    uint8_t firstCode = beam[i].first != 0 ? morseEncode(beam[i].first) : MORSE_EMPTY_CODE;
+    uint8_t firstLength = morseCodeLength(firstCode);
+    uint8_t length = firstLength + morseCodeLength(beam[i].code);
+    if (length == markCount && length <= BEAM_MAX_MARKS) {
+      uint32_t total = 0;
+      for (uint8_t m = 0; m < length; m++) {
+        bool isDash = m < firstLength ? (firstCode >> (firstLength - 1 - m)) & 1
+                                      : (beam[i].code >> (length - 1 - m)) & 1;
+        total += isDash ? marks[m] / 3 : marks[m];
+      }
+      dotEstimate = (uint16_t)((3UL * dotEstimate + total / length) / 4);
+      if (dotEstimate == 0) {
+        dotEstimate = 1;
+      }
+    }
+
+    if (beam[i].first != 0) {
+      _symbols[count++] = beam[i].first;
+    }
+    _symbols[count++] = symbol;
+  }
+
+  beamSize = 1;
+  beam[0].first = 0;
+  beam[0].code = MORSE_EMPTY_CODE;
+  beam[0].cost = 0;
+  markCount = 0;
+  return count;
+}
+
+uint16_t beamDecoderDotEstimate() {
+  return dotEstimate;
+}
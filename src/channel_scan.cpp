@@ -0,0 +1,73 @@
+#include "channel_scan.h"
+#include "channel_switch.h"
+
+static uint8_t channels[SCAN_MAX_CHANNELS];
+static uint8_t channelCount = 0;
+static uint8_t channelIndex = 0;
+static unsigned long dwell = 0;
+static unsigned long hold = 0;
+
+static bool scanning = false;                         // True once channelScanBegin() was given channels
+static bool hopped = false;                           // True once the first hop was started
+static unsigned long listenStart = 0;                 // Time the current channel was last tuned or checked
+static unsigned long lastActivity = 0;                // Time of the last activity on the current channel
+static bool active = false;                           // True while the current channel is held for activity
+
+void channelScanBegin(Stream& _port, uint8_t _setPin, const uint8_t* _channels, uint8_t _count, unsigned long _dwell,
+                      unsigned long _hold) {
+  channelCount = _count < SCAN_MAX_CHANNELS ? _count : SCAN_MAX_CHANNELS;
+  for (uint8_t i = 0; i < channelCount; i++) {
+    channels[i] = _channels[i];
+  }
+  channelIndex = channelCount - 1;                    // The first hop goes to the first channel
+  dwell = _dwell;
+  hold = _hold;
+  active = false;
+  hopped = false;
+
+  channelSwitchBegin(_port, _setPin);
+  scanning = channelCount > 0;
+  listenStart = millis() - dwell;
+}
+
+bool channelScanActive() {
+  return scanning;
+}
+
+void channelScanPoll(unsigned long _now, bool _activity) {
+  if (!scanning) {
+    return;
+  }
+  if (channelSwitchBusy()) {
+    channelSwitchPoll(_now);
+    if (!channelSwitchBusy()) {
+      listenStart = _now;                             // Dwell counts from the end of the hop
+    }
+    return;
+  }
+
+  if (_activity) {
+    active = true;
+    lastActivity = _now;
+  }
+  if (active ? _now - lastActivity < hold : _now - listenStart < dwell) {
+    return;
+  }
+  active = false;
+  if (channelCount < 2 && hopped) {                   // Nothing to hop to
+    listenStart = _now;
+    return;
+  }
+  channelIndex = (channelIndex + 1) % channelCount;
+  hopped = true;
+  channelSwitchStart(channels[channelIndex], _now);
+}
+
+void channelScanHold() {
+  active = true;
+  lastActivity = millis();
+}
+
+uint8_t channelScanChannel() {
+  return channelCount > 0 ? channels[channelIndex] : 0;
+}
@@ -0,0 +1,271 @@
+#include <string.h>
+#include "channel_switch.h"
+#include "trace.h"
+
+static const uint8_t IDLE = 0;                        // Normal mode, the port is free
+static const uint8_t ENTERING = 1;                    // SET low, waiting for configuration mode
+static const uint8_t REPLYING = 2;                    // AT+Cxxx written, waiting for the reply
+static const uint8_t LEAVING = 3;                     // SET high, waiting for normal mode
+static const uint8_t BRIDGING = 4;                    // Configuration mode, bytes are passed between console and module
+
+static const uint8_t JOB_CHANNEL = 0;                 // Channel switch
+static const uint8_t JOB_COMMAND = 1;                 // Other AT command, the reply may span several lines
+static const uint8_t JOB_BRIDGE = 2;                  // Passthrough between the console and the module
+
+static Stream* port = 0;
+static uint8_t setPin = 0;
+static uint8_t channel = 0;
+
+static uint8_t state = IDLE;
+static unsigned long stateTime = 0;                   // Time the current state was entered
+static unsigned long startTime = 0;                   // Time the current switch was started
+static bool replyOk = false;                          // True once the reply started with "OK"
+static uint8_t replyLength = 0;
+static char command[SWITCH_COMMAND_MAX + 1];          // Prepared when the switch starts
+static uint8_t job = JOB_CHANNEL;
+static unsigned long lastReplyTime = 0;               // Time the last reply byte arrived, or bridged byte passed
+static Stream* console = 0;                           // Other end of the bridge
+static unsigned long bridgeIdleTimeout = 0;
+static char reply[SWITCH_REPLY_MAX + 1];
+static uint8_t handoff[SWITCH_HANDOFF_MAX];           // Received bytes that belong to the receive path
+static uint8_t handoffHead = 0;
+static uint8_t handoffCount = 0;
+static bool replyEnded = false;                       // True once the reply to AT+Cxxx reached its line end
+
+static unsigned long switches = 0;
+static unsigned long switchTimeTotal = 0;
+static unsigned long failures = 0;
+
+static void enter(uint8_t _state, unsigned long _now) {
+  state = _state;
+  stateTime = _now;
+}
+
+/*
+@brief Keep the bytes waiting in the port for the receive path, those that do not fit are dropped
+*/
+static void handOff() {
+  while (port->available()) {
+    uint8_t value = port->read();
+    if (handoffCount < SWITCH_HANDOFF_MAX) {
+      handoff[(handoffHead + handoffCount++) % SWITCH_HANDOFF_MAX] = value;
+    }
+  }
+}
+
+/*
+@brief Collect the reply one byte at a time, for AT+Cxxx only up to its line end so what follows is handed off
+*/
+static void readReply(unsigned long _now) {
+  while (!replyEnded && port->available()) {
+    char value = port->read();
+
+    lastReplyTime = _now;
+    if (replyLength < 2) {
+      replyOk = value == "OK"[replyLength];
+    }
+    if (value != '\r' && replyLength < SWITCH_REPLY_MAX) {
+      reply[replyLength++] = value;
+      reply[replyLength] = '\0';
+    }
+    replyEnded = job == JOB_CHANNEL && value == '\n';
+  }
+}
+
+/*
+@brief Check if the reply is complete: its start for a channel switch, a quiet port for other commands
+*/
+static bool replyComplete(unsigned long _now) {
+  if (job == JOB_COMMAND) {
+    return replyLength > 0 && _now - lastReplyTime >= SWITCH_REPLY_QUIET;
+  }
+  return replyEnded;
+}
+
+/*
+@brief Pass waiting bytes between the console and the module, without waiting for either
+*/
+static void bridge(unsigned long _now) {
+  while (console->available()) {
+    port->write(console->read());
+    lastReplyTime = _now;
+  }
+  while (port->available()) {
+    console->write(port->read());
+    lastReplyTime = _now;
+  }
+}
+
+/*
+@brief Drive SET high to leave configuration mode
+*/
+static void leave(unsigned long _now) {
+  digitalWrite(setPin, HIGH);
+  enter(LEAVING, _now);
+}
+
+/*
+@brief Drive SET low to run the prepared command
+*/
+static void startCommand(unsigned long _now) {
+  handOff();                                          // Received in normal mode, before the port is taken over
+  startTime = _now;
+  digitalWrite(setPin, LOW);
+  enter(ENTERING, _now);
+}
+
+void channelSwitchBegin(Stream& _port, uint8_t _setPin) {
+  port = &_port;
+  setPin = _setPin;
+  state = IDLE;
+
+  pinMode(setPin, OUTPUT);
+  digitalWrite(setPin, HIGH);
+}
+
+bool channelSwitchStart(uint8_t _channel, unsigned long _now) {
+  if (port == 0 || state != IDLE) {                   // Not set up yet, or the port belongs to another job
+    return false;
+  }
+
+  channel = _channel;
+  memcpy(command, "AT+C000", 8);
+  command[4] = '0' + channel / 100;
+  command[5] = '0' + channel / 10 % 10;
+  command[6] = '0' + channel % 10;
+  job = JOB_CHANNEL;
+  traceRecord(_now, TRACE_CHANNEL, channel);
+  startCommand(_now);
+  return true;
+}
+
+bool channelSwitchCommand(const char* _command, uint8_t _length, unsigned long _now) {
+  if (port == 0 || _length > SWITCH_COMMAND_MAX) {
+    return false;
+  }
+  channelSwitchFinish();
+
+  memcpy(command, _command, _length);
+  command[_length] = '\0';
+  job = JOB_COMMAND;
+  startCommand(_now);
+  return true;
+}
+
+void channelSwitchBridge(Stream& _console, unsigned long _idleTimeout, unsigned long _now) {
+  if (port == 0) {
+    return;
+  }
+  channelSwitchFinish();
+
+  console = &_console;
+  bridgeIdleTimeout = _idleTimeout;
+  job = JOB_BRIDGE;
+  startCommand(_now);
+}
+
+bool channelSwitchBridging() {
+  return job == JOB_BRIDGE && state != IDLE;
+}
+
+const char* channelSwitchReply() {
+  return reply;
+}
+
+void channelSwitchPoll(unsigned long _now) {
+  switch (state) {
+    case ENTERING:
+      handOff();                                      // Still arriving from normal mode
+      if (_now - stateTime >= SWITCH_SET_LOW_DELAY) {
+        if (job == JOB_BRIDGE) {
+          lastReplyTime = _now;
+          enter(BRIDGING, _now);
+          return;
+        }
+        replyOk = false;
+        replyEnded = false;
+        replyLength = 0;
+        reply[0] = '\0';
+        port->println(command);
+        enter(REPLYING, _now);
+      }
+      return;
+
+    case REPLYING:
+      readReply(_now);
+      if (replyComplete(_now) || _now - stateTime >= SWITCH_REPLY_TIMEOUT) {
+        if (!replyOk && job == JOB_CHANNEL) {
+          failures++;
+        }
+        leave(_now);
+      }
+      return;
+
+    case BRIDGING:
+      bridge(_now);
+      if (_now - lastReplyTime >= bridgeIdleTimeout) {
+        leave(_now);
+      }
+      return;
+
+    case LEAVING:
+      if (job == JOB_BRIDGE) {
+        while (port->available()) {                   // Rest of the last reply
+          console->write(port->read());
+        }
+      } else {
+        handOff();                                    // The reply is complete, this is received in normal mode
+      }
+      if (_now - stateTime >= SWITCH_SET_HIGH_DELAY) {
+        if (job == JOB_CHANNEL) {
+          switches++;
+          switchTimeTotal += _now - startTime;
+        }
+        enter(IDLE, _now);
+      }
+      return;
+
+    default:
+      return;
+  }
+}
+
+void channelSwitchFinish() {
+  if (job == JOB_BRIDGE && (state == ENTERING || state == BRIDGING)) {
+    leave(millis());                                  // A bridge would only end after its idle timeout
+  }
+  while (state != IDLE) {
+    channelSwitchPoll(millis());
+  }
+}
+
+uint8_t channelSwitchPending() {
+  return handoffCount;
+}
+
+uint8_t channelSwitchRead() {
+  uint8_t value = handoff[handoffHead];
+  handoffHead = (handoffHead + 1) % SWITCH_HANDOFF_MAX;
+  handoffCount--;
+  return value;
+}
+
+bool channelSwitchBusy() {
+  return state != IDLE;
+}
+
+uint8_t channelSwitchChannel() {
+  return channel;
+}
+
+unsigned long channelSwitchCount() {
+  return switches;
+}
+
+unsigned long channelSwitchTime() {
+  return switches > 0 ? switchTimeTotal / switches : 0;
+}
+
+unsigned long channelSwitchFailures() {
+  return failures;
+}
@@ -0,0 +1,89 @@
+#include <Arduino.h>
+#include "crypt_benchmark.h"
+#include "secure_frame.h"
+
+static const uint16_t ITERATIONS = 100;
+static const uint8_t payloadSizes[] = {1, 8, 16, FRAME_MAX_PAYLOAD}; // An element line, a word, a sentence, the most
+
+static SecureKey key;
+
+/*
+@brief Check the Speck64/128 test vector, key 1b1a1918 13121110 0b0a0908 03020100
+*/
+static bool checkTestVector() {
+  const uint8_t testKey[SECURE_KEY_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x08, 0x09, 0x0A, 0x0B,
+                                            0x10, 0x11, 0x12, 0x13, 0x18, 0x19, 0x1A, 0x1B};
+  uint32_t block[2] = {0x7475432DUL, 0x3B726574UL};
+
+  secureKeyInit(key, testKey);
+  speckEncrypt(key, block);
+  return block[1] == 0x8C6FA548UL && block[0] == 0x454E028BUL;
+}
+
+/*
+@brief Seal and open a frame, then check that a changed tag is rejected
+*/
+static bool checkRoundTrip() {
+  const uint8_t payload[] = {'1'};
+  uint8_t sealed[FRAME_MAX_WIRE_PAYLOAD];
+  uint8_t length = secureSeal(key, 42, FRAME_LINE, payload, sizeof(payload), sealed);
+  uint32_t counter;
+  Frame inner;
+
+  if (!secureOpen(key, sealed, length, &counter, inner) || counter != 42 || inner.type != FRAME_LINE ||
+      inner.length != 1 || inner.payload[0] != '1') {
+    return false;
+  }
+  sealed[length - 1] ^= 1;
+  return !secureOpen(key, sealed, length, &counter, inner);
+}
+
+static void printTime(const __FlashStringHelper* _name, uint8_t _size, unsigned long _elapsed) {
+  unsigned long cycles = _elapsed * (F_CPU / 1000000UL) / ITERATIONS;
+
+  Serial.print(_name);
+  if (_size > 0) {
+    Serial.print(F(" "));
+    Serial.print(_size);
+    Serial.print(F(" bytes"));
+  }
+  Serial.print(F(": "));
+  Serial.print(cycles);
+  Serial.print(F(" cycles, "));
+  Serial.print(_elapsed / ITERATIONS);
+  Serial.println(F(" us"));
+}
+
+void cryptBenchmarkRun() {
+  Serial.println(F("-----------------------------------"));
+  Serial.println(F("Frame Encryption Benchmark (Speck64/128 CCM)"));
+  Serial.println(checkTestVector() ? F("Test vector: PASS") : F("Test vector: FAIL"));
+  Serial.println(checkRoundTrip() ? F("Round trip: PASS") : F("Round trip: FAIL"));
+
+  uint32_t block[2] = {0, 0};
+  unsigned long start = micros();
+  for (uint16_t i = 0; i < ITERATIONS; i++) {
+    speckEncrypt(key, block);
+  }
+  printTime(F("Block"), 0, micros() - start);
+
+  uint8_t payload[FRAME_MAX_PAYLOAD] = {0};
+  uint8_t sealed[FRAME_MAX_WIRE_PAYLOAD];
+  for (uint8_t i = 0; i < sizeof(payloadSizes); i++) {
+    uint8_t length = 0;
+    start = micros();
+    for (uint16_t j = 0; j < ITERATIONS; j++) {
+      length = secureSeal(key, j, FRAME_TEXT, payload, payloadSizes[i], sealed);
+    }
+    printTime(F("Seal"), payloadSizes[i], micros() - start);
+
+    uint32_t counter;
+    Frame inner;
+    start = micros();
+    for (uint16_t j = 0; j < ITERATIONS; j++) {
+      secureOpen(key, sealed, length, &counter, inner);
+    }
+    printTime(F("Open"), payloadSizes[i], micros() - start);
+  }
+  Serial.println(F("-----------------------------------"));
+}
@@ -0,0 +1,102 @@
+#include "dsp.h"
+#include "pgm_compat.h"
+
+// First quarter of a sine wave in Q15, 64 steps plus the end point
+static const int16_t quarterSine[65] PROGMEM = {
+  0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+  6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+  12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+  18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+  23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+  27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+  30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+  32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+  32767,
+};
+
+int16_t dspSin(uint16_t _phase) {
+  uint16_t angle = _phase & 0x3FFF;
+  if (_phase & 0x4000) {                              // Second and fourth quarter run backwards through the table
+    angle = 0x4000 - angle;
+  }
+
+  uint8_t index = angle >> 8;
+  uint8_t fraction = angle & 0xFF;
+  int16_t value = (int16_t)pgm_read_word(&quarterSine[index]);
+  if (fraction != 0) {
+    int16_t next = (int16_t)pgm_read_word(&quarterSine[index + 1]);
+    value += (int16_t)(((int32_t)(next - value) * fraction) >> 8);
+  }
+
+  return (_phase & 0x8000) ? -value : value;
+}
+
+uint16_t dspPhase(uint32_t _frequency, uint32_t _sampleRate) {
+  return (uint16_t)(((_frequency << 16) + _sampleRate / 2) / _sampleRate);
+}
+
+uint16_t dspSqrt(uint32_t _value) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+
+  while (bit > _value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (_value >= root + bit) {
+      _value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return (uint16_t)root;
+}
+
+void dspGoertzelInit(DspGoertzel& _filter, uint16_t _phase) {
+  _filter.coefficient = dspCos(_phase);              // 2 cos in Q14 has the same bits as cos in Q15
+  _filter.s1 = 0;
+  _filter.s2 = 0;
+}
+
+uint32_t dspGoertzelPower(DspGoertzel& _filter) {
+  int32_t s1 = _filter.s1;
+  int32_t s2 = _filter.s2;
+  int32_t cross = ((_filter.coefficient * s1) >> 14) * s2;
+  int32_t power = s1 * s1 + s2 * s2 - cross;
+
+  _filter.s1 = 0;
+  _filter.s2 = 0;
+  return power > 0 ? (uint32_t)power : 0;
+}
+
+void dspBiquadBandpass(DspBiquad& _filter, uint16_t _phase, uint8_t _q) {
+  int32_t alpha = dspSin(_phase) / (2 * (int16_t)(_q > 0 ? _q : 1)); // Q15
+  int32_t a0 = 32768 + alpha;                         // Q15
+
+  _filter.b0 = (int16_t)((alpha << 14) / a0);
+  _filter.b1 = 0;
+  _filter.b2 = -_filter.b0;
+  _filter.a1 = (int16_t)((int32_t)dspCos(_phase) * -32768 / a0);
+  _filter.a2 = (int16_t)(((32768 - alpha) << 14) / a0);
+  _filter.x1 = _filter.x2 = 0;
+  _filter.y1 = _filter.y2 = 0;
+}
+
+int16_t dspBiquad(DspBiquad& _filter, int16_t _sample) {
+  int32_t accumulator = (int32_t)_filter.b0 * _sample + (int32_t)_filter.b1 * _filter.x1 + (int32_t)_filter.b2 * _filter.x2
+                        - (int32_t)_filter.a1 * _filter.y1 - (int32_t)_filter.a2 * _filter.y2;
+  accumulator >>= 14;
+  if (accumulator > 32767) {
+    accumulator = 32767;
+  } else if (accumulator < -32768) {
+    accumulator = -32768;
+  }
+
+  _filter.x2 = _filter.x1;
+  _filter.x1 = _sample;
+  _filter.y2 = _filter.y1;
+  _filter.y1 = (int16_t)accumulator;
+  return (int16_t)accumulator;
+}
@@ -0,0 +1,34 @@
+#include <Arduino.h>
+#include "dsp_benchmark.h"
+#include "dsp_workload.h"
+
+/*
+@brief Time one run in microseconds, starting from the same seed every time
+*/
+static unsigned long timeRun(uint32_t (*_run)(), uint32_t* _checksum) {
+  dspWorkloadReset();
+  unsigned long start = micros();
+  *_checksum = _run();
+  return micros() - start;
+}
+
+void dspBenchmarkRun() {
+  uint32_t sum;
+  unsigned long overhead = timeRun(dspWorkloadOverhead, &sum);
+
+  Serial.println(F("-----------------------------------"));
+  Serial.println(F("DSP Kernel Benchmark (cycles per call)"));
+  for (uint8_t i = 0; i < dspWorkloadCount; i++) {
+    const DspWorkload& workload = dspWorkloads[i];
+    unsigned long elapsed = timeRun(workload.run, &sum);
+    unsigned long cycles = (elapsed > overhead ? elapsed - overhead : 0) * (F_CPU / 1000000UL) / DSP_WORKLOAD_ITERATIONS;
+
+    Serial.print(workload.name);
+    Serial.print(F(": "));
+    Serial.print(cycles);
+    Serial.print(F(" cycles, checksum "));
+    Serial.print(sum, HEX);
+    Serial.println(sum == workload.expected ? F(" PASS") : F(" FAIL"));
+  }
+  Serial.println(F("-----------------------------------"));
+}
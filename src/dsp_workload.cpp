@@ -0,0 +1,87 @@
+#include "dsp.h"
+#include "dsp_workload.h"
+
+static uint16_t seed = 1;
+
+/*
+@brief Deterministic pseudo-random Q7 sample
+*/
+static int16_t nextSample() {
+  seed = seed * 25173 + 13849;
+  return (int16_t)seed >> 8;
+}
+
+static uint32_t checksum(uint32_t _sum, uint32_t _value) {
+  return (_sum << 5) + (_sum >> 27) + _value;
+}
+
+static uint32_t runSin() {
+  uint32_t sum = 0;
+  for (uint16_t i = 0; i < DSP_WORKLOAD_ITERATIONS; i++) {
+    sum = checksum(sum, (uint16_t)dspSin((uint16_t)nextSample() * 251));
+  }
+  return sum;
+}
+
+static uint32_t runSqrt() {
+  uint32_t sum = 0;
+  for (uint16_t i = 0; i < DSP_WORKLOAD_ITERATIONS; i++) {
+    int16_t sample = nextSample();
+    sum = checksum(sum, dspSqrt((uint32_t)(uint16_t)sample * 65521UL));
+  }
+  return sum;
+}
+
+static uint32_t runEwma() {
+  uint32_t sum = 0;
+  int16_t average = 0;
+  for (uint16_t i = 0; i < DSP_WORKLOAD_ITERATIONS; i++) {
+    average = dspEwma(average, nextSample() * 128, 3);
+    sum = checksum(sum, (uint16_t)average);
+  }
+  return sum;
+}
+
+static uint32_t runGoertzel() {
+  uint32_t sum = 0;
+  DspGoertzel filter;
+  dspGoertzelInit(filter, dspPhase(700, 4000));
+  for (uint16_t i = 0; i < DSP_WORKLOAD_ITERATIONS; i++) {
+    dspGoertzelUpdate(filter, nextSample());
+    if (i % 80 == 79) {
+      sum = checksum(sum, dspGoertzelPower(filter));
+    }
+  }
+  return checksum(sum, (uint16_t)filter.s1);
+}
+
+static uint32_t runBiquad() {
+  uint32_t sum = 0;
+  DspBiquad filter;
+  dspBiquadBandpass(filter, dspPhase(700, 4000), 5);
+  for (uint16_t i = 0; i < DSP_WORKLOAD_ITERATIONS; i++) {
+    sum = checksum(sum, (uint16_t)dspBiquad(filter, nextSample() * 128));
+  }
+  return sum;
+}
+
+const DspWorkload dspWorkloads[] = {
+  {"Sin", runSin, 0xA800D002},
+  {"Sqrt", runSqrt, 0x93A688A9},
+  {"Ewma", runEwma, 0xFC12EB05},
+  {"Goertzel", runGoertzel, 0x82D5B3B2},
+  {"Biquad", runBiquad, 0xCDD0BEE2},
+};
+const uint8_t dspWorkloadCount = sizeof(dspWorkloads) / sizeof(dspWorkloads[0]);
+
+void dspWorkloadReset() {
+  seed = 1;
+}
+
+uint32_t dspWorkloadOverhead() {
+  uint32_t sum = 0;
+  for (uint16_t i = 0; i < DSP_WORKLOAD_ITERATIONS; i++) {
+    sum = checksum(sum, (uint16_t)nextSample());
+  }
+  return sum;
+}
@@ -0,0 +1,70 @@
+#include "element_stream.h"
+#include <string.h>
+
+uint8_t varintEncode(uint16_t _value, uint8_t* _out) {
+  uint8_t size = 0;
+  while (_value >= 0x80) {
+    _out[size++] = (uint8_t)_value | 0x80;
+    _value >>= 7;
+  }
+  _out[size++] = (uint8_t)_value;
+  return size;
+}
+
+uint8_t varintDecode(const uint8_t* _data, uint8_t _length, uint16_t* _value) {
+  uint32_t value = 0;
+
+  for (uint8_t i = 0; i < _length && i < VARINT_MAX_SIZE; i++) {
+    value |= (uint32_t)(_data[i] & 0x7F) << (7 * i);
+    if ((_data[i] & 0x80) == 0) {
+      if (value > 0xFFFF) {
+        return 0;
+      }
+      *_value = (uint16_t)value;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+void elementStreamInit(ElementStream& _stream, uint8_t* _bits, uint8_t _size) {
+  _stream.bits = _bits;
+  _stream.size = _size;
+  _stream.count = 0;
+  memset(_bits, 0, _size);
+}
+
+bool elementStreamAppend(ElementStream& _stream, uint8_t _item) {
+  if ((_stream.count >> 2) >= _stream.size) {
+    return false;
+  }
+  _stream.bits[_stream.count >> 2] |= (_item & 3) << ((_stream.count & 3) << 1);
+  _stream.count++;
+  return true;
+}
+
+uint8_t elementStreamEncode(const ElementStream& _stream, uint8_t* _out, uint8_t _outSize) {
+  uint8_t header[VARINT_MAX_SIZE];
+  uint8_t headerSize = varintEncode(_stream.count, header);
+  uint16_t bitsSize = (_stream.count + 3) >> 2;
+
+  if (headerSize + bitsSize > _outSize) {
+    return 0;
+  }
+
+  memcpy(_out, header, headerSize);
+  memcpy(_out + headerSize, _stream.bits, bitsSize);
+  return headerSize + bitsSize;
+}
+
+uint16_t elementStreamDecode(const uint8_t* _data, uint8_t _length, const uint8_t** _bits) {
+  uint16_t count;
+  uint8_t headerSize = varintDecode(_data, _length, &count);
+
+  if (headerSize == 0 || headerSize + (((uint32_t)count + 3) >> 2) != _length) {
+    return 0;                                         // 32 bit, count + 3 wraps in 16 bit int on the AVR
+  }
+
+  *_bits = _data + headerSize;
+  return count;
+}
@@ -0,0 +1,93 @@
+#include "fault_injector.h"
+
+static uint16_t nextRandom(FaultInjector& _injector) {
+  uint32_t x = _injector.random;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  _injector.random = x;
+  return (uint16_t)(x >> 16);
+}
+
+static bool chance(FaultInjector& _injector, uint16_t _rate) {
+  return _rate != 0 && nextRandom(_injector) < _rate;
+}
+
+void faultInit(FaultInjector& _injector, const FaultConfig& _config, uint32_t _seed) {
+  _injector.config = _config;
+  _injector.stats = FaultStats();
+  _injector.random = _seed != 0 ? _seed : 0x9E3779B9UL;
+  _injector.fading = false;
+}
+
+FaultConfig faultConfigForRate(uint8_t _percent) {
+  uint16_t share = (uint16_t)(_percent * FAULT_RATE_PERCENT / 4);
+  FaultConfig config;
+  config.dropRate = share;
+  config.flipRate = share;
+  config.duplicateRate = share;
+  config.reorderRate = share;
+  config.truncateRate = share;
+  config.burstEnterRate = share / 4;                  // Fades are rare but take several bytes each
+  config.burstExitRate = 65535 / 3;
+  return config;
+}
+
+uint16_t faultApply(FaultInjector& _injector, const uint8_t* _data, uint16_t _length, uint8_t* _out) {
+  const FaultConfig& config = _injector.config;
+  FaultStats& stats = _injector.stats;
+  uint16_t size = 0;
+  uint16_t length = _length;
+  bool holding = false;                               // True while a byte waits to be sent after the next one
+  uint8_t held = 0;
+
+  stats.bytesIn += _length;
+
+  if (length > 1 && chance(_injector, config.truncateRate)) {
+    length = 1 + nextRandom(_injector) % (length - 1);
+    stats.truncated++;
+  }
+
+  for (uint16_t i = 0; i < length; i++) {
+    uint8_t value = _data[i];
+
+    if (_injector.fading ? !chance(_injector, config.burstExitRate) : chance(_injector, config.burstEnterRate)) {
+      _injector.fading = true;
+      stats.fadeDropped++;
+      continue;
+    }
+    _injector.fading = false;
+
+    if (chance(_injector, config.dropRate)) {
+      stats.dropped++;
+      continue;
+    }
+    if (chance(_injector, config.flipRate)) {
+      value ^= 1 << (nextRandom(_injector) & 7);
+      stats.flipped++;
+    }
+    if (!holding && i + 1 < length && chance(_injector, config.reorderRate)) {
+      held = value;
+      holding = true;
+      stats.reordered++;
+      continue;
+    }
+
+    _out[size++] = value;
+    if (chance(_injector, config.duplicateRate)) {
+      _out[size++] = value;
+      stats.duplicated++;
+    }
+    if (holding) {
+      _out[size++] = held;
+      holding = false;
+    }
+  }
+
+  if (holding) {                                      // The byte it was swapped with was lost
+    _out[size++] = held;
+  }
+
+  stats.bytesOut += size;
+  return size;
+}
@@ -0,0 +1,86 @@
+#include "frame.h"
+
+// Parser states
+static const uint8_t WAIT_START = 0;
+static const uint8_t WAIT_TYPE = 1;
+static const uint8_t WAIT_LENGTH = 2;
+static const uint8_t WAIT_PAYLOAD = 3;
+static const uint8_t WAIT_CRC = 4;
+
+uint8_t frameCrc8(uint8_t _crc, uint8_t _byte) {
+  _crc ^= _byte;
+  for (uint8_t i = 0; i < 8; i++) {
+    _crc = (_crc & 0x80) ? (_crc << 1) ^ 0x07 : _crc << 1;
+  }
+  return _crc;
+}
+
+uint8_t frameEncode(uint8_t _type, const uint8_t* _payload, uint8_t _length, uint8_t* _out) {
+  if (_length > FRAME_MAX_WIRE_PAYLOAD) {
+    return 0;
+  }
+
+  uint8_t crc = frameCrc8(frameCrc8(0, _type), _length);
+  _out[0] = FRAME_START;
+  _out[1] = _type;
+  _out[2] = _length;
+  for (uint8_t i = 0; i < _length; i++) {
+    _out[3 + i] = _payload[i];
+    crc = frameCrc8(crc, _payload[i]);
+  }
+  _out[3 + _length] = crc;
+
+  return _length + FRAME_OVERHEAD;
+}
+
+void frameParserReset(FrameParser& _parser) {
+  _parser.state = WAIT_START;
+  _parser.index = 0;
+  _parser.crc = 0;
+}
+
+bool frameParserBusy(const FrameParser& _parser) {
+  return _parser.state != WAIT_START;
+}
+
+int8_t frameParserFeed(FrameParser& _parser, uint8_t _byte) {
+  switch (_parser.state) {
+    case WAIT_START:
+      if (_byte == FRAME_START) {
+        _parser.state = WAIT_TYPE;
+        _parser.crc = 0;
+      }
+      return FRAME_INCOMPLETE;
+
+    case WAIT_TYPE:
+      _parser.frame.type = _byte;
+      _parser.crc = frameCrc8(_parser.crc, _byte);
+      _parser.state = WAIT_LENGTH;
+      return FRAME_INCOMPLETE;
+
+    case WAIT_LENGTH:
+      if (_byte > FRAME_MAX_WIRE_PAYLOAD) {
+        frameParserReset(_parser);
+        return FRAME_ERROR;
+      }
+      _parser.frame.length = _byte;
+      _parser.crc = frameCrc8(_parser.crc, _byte);
+      _parser.index = 0;
+      _parser.state = _byte > 0 ? WAIT_PAYLOAD : WAIT_CRC;
+      return FRAME_INCOMPLETE;
+
+    case WAIT_PAYLOAD:
+      _parser.frame.payload[_parser.index++] = _byte;
+      _parser.crc = frameCrc8(_parser.crc, _byte);
+      if (_parser.index >= _parser.frame.length) {
+        _parser.state = WAIT_CRC;
+      }
+      return FRAME_INCOMPLETE;
+
+    default: {
+      bool valid = _byte == _parser.crc;
+      frameParserReset(_parser);
+      return valid ? FRAME_COMPLETE : FRAME_ERROR;
+    }
+  }
+}
@@ -0,0 +1,60 @@
+#include "gesture.h"
+
+static bool commandMode = false;                      // True while presses are collected as commands
+static uint8_t pendingEvent = GESTURE_NONE;           // Enter/exit event to report on the next poll
+static uint8_t commandCode = 1;                       // Packed code of the letter being keyed, 1 = empty
+static unsigned long lastInputTime = 0;               // Release time of the last consumed press
+
+bool gestureActive() {
+  return commandMode;
+}
+
+bool gestureOnPress(unsigned long _pressDuration, bool _isDash, unsigned long _now) {
+  if (_pressDuration > GESTURE_HOLD_DURATION) {       // Very long hold toggles command mode
+    commandMode = !commandMode;
+    pendingEvent = commandMode ? GESTURE_ENTER : GESTURE_EXIT;
+    commandCode = 1;
+    lastInputTime = _now;
+    return true;
+  }
+
+  if (!commandMode) {                                 // Normal keying, leave the element alone
+    return false;
+  }
+
+  if (commandCode & 0x40) {                           // Longer than 6 elements, no command is that long
+    commandCode = GESTURE_INVALID;
+  } else if (commandCode != GESTURE_INVALID) {
+    commandCode = (commandCode << 1) | (_isDash ? 1 : 0);
+  }
+  lastInputTime = _now;
+  return true;
+}
+
+uint8_t gesturePoll(unsigned long _now) {
+  if (pendingEvent != GESTURE_NONE) {
+    uint8_t event = pendingEvent;
+    pendingEvent = GESTURE_NONE;
+    return event;
+  }
+
+  if (!commandMode) {
+    return GESTURE_NONE;
+  }
+
+  unsigned long idle = _now - lastInputTime;
+
+  if (commandCode != 1 && idle > GESTURE_COMMIT_GAP) {
+    uint8_t command = commandCode;
+    commandCode = 1;
+    lastInputTime = _now;
+    return command;
+  }
+
+  if (idle > GESTURE_IDLE_TIMEOUT) {
+    commandMode = false;
+    return GESTURE_EXIT;
+  }
+
+  return GESTURE_NONE;
+}
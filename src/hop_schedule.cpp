@@ -0,0 +1,121 @@
+#include "hop_schedule.h"
+
+/*
+@brief Mix the seed and cycle number into a non-zero xorshift state
+*/
+static uint32_t cycleState(uint32_t _seed, uint32_t _cycle) {
+  uint32_t state = _seed ^ (_cycle * 0x9E3779B9UL);
+
+  state ^= state >> 16;
+  state *= 0x45D9F3BUL;
+  state ^= state >> 16;
+  return state ? state : 1;
+}
+
+void hopInit(HopSchedule& _schedule, uint32_t _seed, const uint8_t* _channels, uint8_t _count) {
+  _schedule.seed = _seed;
+  _schedule.count = _count < HOP_MAX_CHANNELS ? _count : HOP_MAX_CHANNELS;
+  _schedule.badMask = 0;
+  _schedule.skipMask = 0;
+  for (uint8_t i = 0; i < _schedule.count; i++) {
+    _schedule.channels[i] = _channels[i];
+    _schedule.expected[i] = 0;
+    _schedule.lost[i] = 0;
+    _schedule.probation[i] = 0;
+    _schedule.totalExpected[i] = 0;
+    _schedule.totalLost[i] = 0;
+  }
+}
+
+uint8_t hopUsableChannels(const HopSchedule& _schedule) {
+  uint8_t usable = 0;
+
+  for (uint8_t i = 0; i < _schedule.count; i++) {
+    if (!(_schedule.skipMask & (1U << i))) {
+      usable++;
+    }
+  }
+  return usable;
+}
+
+uint8_t hopChannelIndex(const HopSchedule& _schedule, uint32_t _slot) {
+  uint8_t order[HOP_MAX_CHANNELS];
+  uint8_t usable = 0;
+
+  for (uint8_t i = 0; i < _schedule.count; i++) {
+    if (!(_schedule.skipMask & (1U << i))) {
+      order[usable++] = i;
+    }
+  }
+  if (usable == 0) {
+    return 0;
+  }
+
+  // Shuffle the usable channels for this cycle (Fisher-Yates) and take the slot's position in it
+  uint32_t state = cycleState(_schedule.seed, _slot / usable);
+  for (uint8_t i = usable - 1; i > 0; i--) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    uint8_t j = state % (i + 1);
+    uint8_t swap = order[i];
+    order[i] = order[j];
+    order[j] = swap;
+  }
+  return order[_slot % usable];
+}
+
+uint8_t hopChannel(const HopSchedule& _schedule, uint32_t _slot) {
+  return _schedule.count > 0 ? _schedule.channels[hopChannelIndex(_schedule, _slot)] : 0;
+}
+
+bool hopRecord(HopSchedule& _schedule, uint8_t _index, bool _expected, bool _received) {
+  if (_index >= _schedule.count) {
+    return false;
+  }
+
+  bool markedBad = false;
+
+  for (uint8_t i = 0; i < _schedule.count; i++) {     // Bad channels serve their probation
+    if ((_schedule.badMask & (1U << i)) && --_schedule.probation[i] == 0) {
+      _schedule.badMask &= ~(1U << i);
+    }
+  }
+
+  if (_expected) {
+    _schedule.expected[_index]++;
+    _schedule.totalExpected[_index]++;
+    if (!_received) {
+      _schedule.lost[_index]++;
+      _schedule.totalLost[_index]++;
+    }
+    if (_schedule.expected[_index] >= HOP_STATS_WINDOW) {
+      if (_schedule.lost[_index] * 100U >= HOP_BAD_LOSS_PERCENT * (unsigned)HOP_STATS_WINDOW) {
+        _schedule.badMask |= 1U << _index;
+        _schedule.probation[_index] = HOP_PROBATION_SLOTS;
+        markedBad = true;
+      }
+      _schedule.expected[_index] = 0;
+      _schedule.lost[_index] = 0;
+    }
+  }
+
+  return markedBad;
+}
+
+uint16_t hopProposeSkipMask(const HopSchedule& _schedule, uint16_t _peerMask) {
+  uint16_t all = (uint16_t)((1UL << _schedule.count) - 1);
+  uint16_t skip = (_schedule.badMask | _peerMask) & all;
+  uint8_t usable = 0;
+
+  for (uint8_t i = 0; i < _schedule.count; i++) {
+    if (!(skip & (1U << i))) {
+      usable++;
+    }
+  }
+  return usable >= HOP_MIN_CHANNELS ? skip : 0;     // Too much is bad, hopping over everything is still better
+}
+
+void hopSetSkipMask(HopSchedule& _schedule, uint16_t _skipMask) {
+  _schedule.skipMask = _skipMask & (uint16_t)((1UL << _schedule.count) - 1);
+}
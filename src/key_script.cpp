@@ -0,0 +1,110 @@
+#include "key_script.h"
+#include "pgm_compat.h"
+
+static const uint16_t* flashScript = 0;               // Running flash script, 0 if the text script runs
+static uint16_t textScript[KEY_SCRIPT_MAX_EDGES];     // Running text script
+static uint8_t scriptCount = 0;                       // Durations in the running script, 0 if none runs
+static bool scriptRepeat = false;
+static uint8_t edge = 0;                              // Index of the duration in progress
+static unsigned long edgeTime = 0;                    // Time the duration in progress started
+static bool started = false;                          // True once the first edge was observed
+
+static uint16_t lineValues[KEY_SCRIPT_MAX_EDGES];     // Durations of the line being received
+static uint8_t lineCount = 0;
+static uint16_t lineValue = 0;                        // Digits of the duration being received
+static bool lineHasValue = false;
+static bool lineInvalid = false;
+
+static uint16_t duration(uint8_t _index) {
+  return flashScript != 0 ? pgm_read_word(&flashScript[_index]) : textScript[_index];
+}
+
+static void start(uint8_t _count, bool _repeat) {
+  scriptCount = _count;
+  scriptRepeat = _repeat;
+  edge = 0;
+  started = false;
+}
+
+void keyScriptStart(const uint16_t* _script, uint8_t _count, bool _repeat) {
+  flashScript = _script;
+  start(_count, _repeat);
+}
+
+void keyScriptStop() {
+  scriptCount = 0;
+}
+
+bool keyScriptActive() {
+  return scriptCount > 0;
+}
+
+/*
+@brief Add the duration being received to the line
+*/
+static void endValue() {
+  if (!lineHasValue) {
+    return;
+  }
+  if (lineCount < KEY_SCRIPT_MAX_EDGES) {
+    lineValues[lineCount++] = lineValue;
+  } else {
+    lineInvalid = true;
+  }
+  lineValue = 0;
+  lineHasValue = false;
+}
+
+bool keyScriptFeed(uint8_t _byte) {
+  if (_byte >= '0' && _byte <= '9') {
+    uint32_t value = lineValue * 10UL + (_byte - '0');
+    lineInvalid = lineInvalid || value > 0xFFFF;
+    lineValue = (uint16_t)value;
+    lineHasValue = true;
+    return false;
+  }
+  if (_byte == ' ' || _byte == '\r') {
+    endValue();
+    return false;
+  }
+  if (_byte != '\n') {
+    lineInvalid = true;
+    return false;
+  }
+
+  endValue();
+  bool valid = !lineInvalid && lineCount > 0;
+  if (valid) {
+    for (uint8_t i = 0; i < lineCount; i++) {
+      textScript[i] = lineValues[i];
+    }
+    flashScript = 0;
+    start(lineCount, false);
+  }
+  lineCount = 0;
+  lineInvalid = false;
+  return valid;
+}
+
+bool keyScriptDown(unsigned long _now) {
+  if (scriptCount == 0) {
+    return false;
+  }
+  if (!started) {                                     // The first press starts when the script is first read
+    started = true;
+    edgeTime = _now;
+  }
+
+  // Zero durations are skipped, but never more than one round of them
+  for (uint8_t skipped = 0; _now - edgeTime >= duration(edge) && skipped <= scriptCount; skipped++) {
+    edgeTime = _now;                                  // Count the next duration from when this edge was seen
+    if (++edge >= scriptCount) {
+      if (!scriptRepeat) {
+        scriptCount = 0;
+        return false;
+      }
+      edge = 0;
+    }
+  }
+  return (edge & 1) == 0;                             // Even durations are key down
+}
@@ -0,0 +1,56 @@
+#include <EEPROM.h>
+#include "key_store.h"
+
+static const int KEY_ADDRESS = KEY_STORE_ADDRESS + 1;
+static const int SEND_COUNTER_ADDRESS = KEY_ADDRESS + SECURE_KEY_SIZE;
+static const int RECEIVE_FLOOR_ADDRESS = SEND_COUNTER_ADDRESS + 4;
+
+static uint32_t readWord(int _address) {
+  uint32_t value = 0;
+
+  for (uint8_t i = 0; i < 4; i++) {
+    value |= (uint32_t)EEPROM.read(_address + i) << (8 * i);
+  }
+  return value;
+}
+
+static void writeWord(int _address, uint32_t _value) {
+  for (uint8_t i = 0; i < 4; i++) {
+    EEPROM.update(_address + i, (uint8_t)(_value >> (8 * i)));  // Bytes that did not change are not written
+  }
+}
+
+bool keyStoreLoad(uint8_t* _key) {
+  if (EEPROM.read(KEY_STORE_ADDRESS) != KEY_STORE_MARKER) {
+    return false;
+  }
+  for (uint8_t i = 0; i < SECURE_KEY_SIZE; i++) {
+    _key[i] = EEPROM.read(KEY_ADDRESS + i);
+  }
+  return true;
+}
+
+void keyStoreSave(const uint8_t* _key) {
+  for (uint8_t i = 0; i < SECURE_KEY_SIZE; i++) {
+    EEPROM.update(KEY_ADDRESS + i, _key[i]);
+  }
+  writeWord(SEND_COUNTER_ADDRESS, 0);
+  writeWord(RECEIVE_FLOOR_ADDRESS, 0);
+  EEPROM.update(KEY_STORE_ADDRESS, KEY_STORE_MARKER);
+}
+
+uint32_t keyStoreSendCounter() {
+  return readWord(SEND_COUNTER_ADDRESS);
+}
+
+void keyStoreSaveSendCounter(uint32_t _counter) {
+  writeWord(SEND_COUNTER_ADDRESS, _counter);
+}
+
+uint32_t keyStoreReceiveFloor() {
+  return readWord(RECEIVE_FLOOR_ADDRESS);
+}
+
+void keyStoreSaveReceiveFloor(uint32_t _floor) {
+  writeWord(RECEIVE_FLOOR_ADDRESS, _floor);
+}
@@ -0,0 +1,67 @@
+#include "loopback_stream.h"
+
+LoopbackStream::LoopbackStream(unsigned long _baudRate, unsigned long _airLatency)
+  : head(0), count(0), byteTime(10000000UL / _baudRate), airLatency(_airLatency), headReadyTime(0), overflowCount(0) {
+}
+
+void LoopbackStream::begin(unsigned long _baudRate) {
+  byteTime = 10000000UL / _baudRate;
+}
+
+bool LoopbackStream::headReady() {
+  return count > 0 && (long)(micros() - headReadyTime) >= 0;
+}
+
+int LoopbackStream::available() {
+  // Only bytes that have arrived count, at most one byte time apart
+  if (!headReady()) {
+    return 0;
+  }
+  unsigned long arrived = (micros() - headReadyTime) / byteTime + 1;
+  return arrived < count ? (int)arrived : count;
+}
+
+int LoopbackStream::read() {
+  if (!headReady()) {
+    return -1;
+  }
+
+  uint8_t value = buffer[head];
+  head = (head + 1) % BUFFER_SIZE;
+  count--;
+  headReadyTime += byteTime;
+  return value;
+}
+
+int LoopbackStream::peek() {
+  return headReady() ? buffer[head] : -1;
+}
+
+size_t LoopbackStream::write(uint8_t _byte) {
+  if (count >= BUFFER_SIZE) {
+    overflowCount++;
+    return 0;
+  }
+
+  if (count == 0) {                                   // Start of a burst
+    unsigned long ready = micros() + byteTime + airLatency;
+    if ((long)(ready - headReadyTime) > 0) {
+      headReadyTime = ready;
+    }
+  }
+  buffer[(head + count) % BUFFER_SIZE] = _byte;
+  count++;
+  delayMicroseconds(byteTime);                        // Sending blocks for one byte time, like SoftwareSerial
+  return 1;
+}
+
+void LoopbackStream::flush() {
+}
+
+unsigned long LoopbackStream::overflows() const {
+  return overflowCount;
+}
+
+uint8_t LoopbackStream::pending() const {
+  return count;
+}
@@ -1,13 +1,33 @@
 #include <Arduino.h>
 #include <SoftwareSerial.h>
+#include "beam_decoder.h"
+#include "board.h"
+#include "channel_scan.h"
+#include "channel_switch.h"
+#include "crypt_benchmark.h"
+#include "dsp_benchmark.h"
+#include "element_stream.h"
+#include "fault_injector.h"
+#include "feature_flags.h"
+#include "frame.h"
+#include "gesture.h"
+#include "key_store.h"
+#include "hop_schedule.h"
+#include "key_script.h"
+#include "latency_probe.h"
+#include "loopback_stream.h"
+#include "morse_codec.h"
+#include "morse_timing.h"
+#include "playback.h"
+#include "replay_window.h"
+#include "rx_parser.h"
+#include "secure_frame.h"
+#include "serial_shell.h"
+#include "text_compress.h"
+#include "tone_input.h"
+#include "trace.h"
 
-// Declare constants for the pin numbers of the button, led, buzzer, and HC12 pins
-const byte BUTTON_PIN = 2;                            // Momentary push-button switch accross pin 2 and GND
-const byte LED_PIN = 4;                               // 5mm Red LED with current limiting resistor accross pin 4 and GND
-const byte BUZZER_PIN = 6;                            // 5V Active Buzzer accross pin 6 and GND
-const byte HC12_SET_PIN = 8;                          // HC-12 SET pin for configuration mode (active low) 
-const byte HC12_TX_PIN = 10;                          // HC-12 TX pin connected to Arduino RX pin
-const byte HC12_RX_PIN = 12;                          // HC-12 RX pin connected to Arduino TX pin 
+// The pin numbers of the button, LED, buzzer, HC-12 and tone input come from the board selected in board.h
 
 //Initiate an instance of the Software Serial Object for the HC-12 module
 SoftwareSerial morse(HC12_TX_PIN, HC12_RX_PIN);       // RX, TX (Arduino Uno Software Serial)
@@ -16,34 +36,326 @@ bool testMode = false;                                // Set to true to enable H
 bool isInitiator = false;                             // Set to true if this device is the initiator of the communication
 const bool  toTestBuzzerLedAndButton = false;         // Set to true to test buzzer, LED and button functionality
 const bool hcTestMode = false;                        // Set to true to enable HC-12 configuration mode
+const bool dspBenchmarkMode = false;                  // Set to true to check and time the DSP kernels at startup
+const bool loopbackTestMode = LOOPBACK_TEST;          // Build with LOOPBACK_TEST=1 to receive everything this unit sends and time keying to sounder
+
+// Elements and frames go through radio, which is the HC-12 or, in loopback test mode, a simulated pair of HC-12s
+#if LOOPBACK_TEST
+LoopbackStream loopback(9600, 4000);                  // 9600 baud with about 4 ms of HC-12 air latency (FU3)
+Stream& radio = loopback;
+#else
+Stream& radio = morse;
+#endif
+
+const bool faultInjectionEnabled = false;             // Set to true to damage everything sent via radio, best with LOOPBACK_TEST
+const uint8_t faultInjectionPercent = 5;              // Approximate share of damaged bytes when fault injection is enabled
+const uint32_t faultInjectionSeed = 1;                // Same seed, same faults
+const bool throughputBenchmarkMode = false;           // Set to true to measure link throughput at startup, see startThroughputBenchmark()
+const bool faultSweepMode = false;                    // Set to true to print frame throughput and goodput against error rate at startup
+FaultInjector radioFaults;                            // Fault injection state for the radio write path
+
+// Frame encryption, built with SECURE_FRAMES=1: everything sent is sealed with the link key from EEPROM and anything
+// received that is not sealed with it is dropped, see secure_frame.h. Exactly one of the two devices must have
+// isInitiator set.
+const bool provisionLinkKey = false;                  // Set to true once to store linkKeyToProvision in EEPROM, then clear both again
+const uint8_t linkKeyToProvision[SECURE_KEY_SIZE] = {0}; // Random key, the same on both devices
+const bool cryptBenchmarkMode = false;                // Set to true to check and time the frame encryption at startup
+#if SECURE_FRAMES
+SecureKey linkKey;                                    // Expanded link key
+bool linkKeyLoaded = false;                           // True once the link key was read from EEPROM
+uint32_t secureCounter = 0;                           // Counter of the next sealed frame, without SECURE_SENDER_BIT
+uint32_t secureCounterReserved = 0;                   // Send counters are reserved in EEPROM up to this one
+ReplayWindow replayWindow;                            // Counters already received from the other device
+uint32_t replayFloorSaved = 0;                        // Lowest counter from the other device accepted after a reset
+const unsigned long counterSyncInterval = 1000;       // Tell the other device the receive floor at most this often in milliseconds
+bool counterSyncDue = false;                          // True if the other device may be counting below the receive floor
+unsigned long lastCounterSync = 0;                    // Time the receive floor was last sent
+unsigned long secureRejected = 0;                     // Received messages dropped because they were not sealed with the link key
+unsigned long replayRejected = 0;                     // Sealed frames dropped because their counter was already used
+#endif
+
+const bool channelScanMode = false;                   // Set to true to scan scanChannels for activity instead of staying on one channel
+const uint8_t scanChannels[] = {1, 5, 10, 20};        // HC-12 channels to scan, both devices need at least one in common
+const unsigned long scanDwell = 100;                  // Time to listen to a quiet channel in milliseconds
+const unsigned long scanActivityHold = 5000;          // Time a channel is held after the last activity on it in milliseconds
+
+// Frequency hopping, built with FREQUENCY_HOPPING=1: the initiator keeps the time, both devices hop over hopChannels in
+// the order hop_schedule.h derives from hopSeed, and channels that lose too many beacons are skipped. Do not combine
+// with channelScanMode.
+#if FREQUENCY_HOPPING
+const uint8_t hopChannels[] = {1, 5, 10, 20, 30, 40, 50, 60}; // HC-12 channels to hop over, same list on both devices
+const uint32_t hopSeed = 0x4D6F7273;                  // Shared hopping seed, same on both devices
+const unsigned long hopSlotLength = 2000;             // Time on each channel in milliseconds, same on both devices
+const unsigned long hopGuard = 60;                    // Nothing paced is sent this long before a hop in milliseconds
+const unsigned long hopBeaconOffset = 250;            // The initiator's beacon goes out this long into a slot, after the slowest switch
+const unsigned long hopBeaconLatency = 20;            // A beacon's time on air, about 15 bytes at 9600 baud plus air latency
+const uint8_t hopSyncTimeout = 8;                     // Slots without a beacon after which the other device counts as gone
+const uint8_t hopMaskDelay = 4;                       // Slots a new skip mask is announced before it takes effect
+HopSchedule hopSchedule;                              // Channel order and per-channel loss
+uint32_t hopSlot = 0;                                 // Number of the current slot
+unsigned long hopSlotStart = 0;                       // Time the current slot started
+uint8_t hopIndex = 0;                                 // Index into hopChannels of the current slot
+bool hopSynced = false;                               // True while the slots follow the initiator, always true on it
+bool hopPeerHeard = false;                            // True once a beacon from the other device arrived
+uint32_t hopLastHeard = 0;                            // Slot of the last beacon from the other device
+bool hopBeaconReceived = false;                       // True once a beacon from the other device arrived in this slot
+bool hopBeaconSent = false;                           // True once the initiator sent its beacon in this slot
+bool hopReplyDue = false;                             // True if the follower has to answer the initiator's beacon
+bool hopDeferred = false;                             // True if this slot stayed on the last channel, the HC-12 was busy
+uint16_t hopPeerBad = 0;                              // Channels the other device measured as bad, on the initiator
+uint16_t hopNextSkip = 0;                             // Skip mask announced to take effect in hopNextSkipSlot
+uint32_t hopNextSkipSlot = 0;
+#endif
+
+// How keyed elements are sent via HC-12
+const byte SEND_ELEMENTS = 0;                         // One "1"/"2" line per element, as soon as it is keyed
+const byte SEND_ELEMENT_STREAM = 1;                   // The elements of a character bit packed into one frame
+const byte SEND_CHARACTERS = 2;                       // Decoded words in compressed text frames
+const byte sendModeCount = 3;
+byte sendMode = SEND_ELEMENTS;                        // Set to one of the SEND_* modes, can be changed in command mode
+const unsigned int toneInputFrequency = 700;          // Frequency of the tone to detect in Hz, with TONE_INPUT
+const bool scriptedKeying = false;                    // Set to true to key from parisScript and serial monitor scripts instead of the button
+const bool serialShellEnabled = true;                 // Set to false to ignore commands from the serial monitor, see serial_shell.h
+const bool useBeamDecoder = true;                     // Set to false to decode characters with the fixed dot/dash threshold
 int hc12TestValue = 0;
 
 int morseToSend = 0;                                  // Variable to hold the value to send via HC-12
 int morseReceived = 0;                                // Variable to hold the received value from HC-12
 
-unsigned long dashDuration = 600;                     // Duration for dash in milliseconds
-unsigned long dotDuration = 200;                      // Duration for dot in milliseconds
-unsigned long morseInterval = 1000;                   // Interval between dots and dashes in milliseconds
+const uint8_t keyingWpm = 2;                          // Expected keying speed, the dot/dash and character/word gap thresholds follow from it
+MorseTiming keyingTiming;                             // Standard timing at keyingWpm, see morse_timing.h
+MorseTiming playbackTiming;                           // Standard timing at playbackWpm, with Farnsworth spacing if set
 
-unsigned long buttonDotPressDuration = 500;           // Duration for button press in milliseconds
-unsigned long buttonDashPressDuration = 1000;         // Duration for button press for dash in milliseconds
+// "PARIS " keyed at keyingWpm as alternating key down/up durations in milliseconds, used when scriptedKeying is set
+const uint16_t SCRIPT_DOT = 1200 / keyingWpm;         // One dot, also the gap between elements
+const uint16_t SCRIPT_DASH = 3 * SCRIPT_DOT;          // Three dots, also the gap between characters
+const uint16_t SCRIPT_WORD = 7 * SCRIPT_DOT;          // Seven dots
+const uint16_t parisScript[] PROGMEM = {
+  SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DASH, SCRIPT_DOT, SCRIPT_DASH, SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DASH,   // P .--.
+  SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DASH, SCRIPT_DASH,                                                   // A .-
+  SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DASH, SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DASH,                           // R .-.
+  SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DASH,                                                    // I ..
+  SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DOT, SCRIPT_DOT, SCRIPT_WORD,                            // S ...
+};
 
 unsigned long lastButtonPressTime = 0;                // Variable to hold the last button press time
+unsigned long lastPressDuration = 0;                  // Duration of the last press measured by talkMorse()
+bool keyPressed = false;                              // True while talkMorse() times a press
+unsigned long keyReleaseTime = 0;                     // Time the last press ended
+const unsigned long keyDebounce = 50;                 // The key is ignored this long after a release (ms)
+bool dashBeeped = false;                              // True once the current press beeped at the dash threshold
+bool gestureBeeped = false;                           // True once it beeped at the command mode gesture threshold
+
+byte beepsLeft = 0;                                   // Beeps of the current beepAndBuzz() pattern still to start
+unsigned int beepDuration = 0;                        // Length of each beep in milliseconds
+const unsigned long beepPause = 200;                  // Silence between beeps in milliseconds
+bool beepOn = false;                                  // True while a beep sounds
+unsigned long beepTime = 0;                           // Time the current beep or pause started
+bool sounderOn = false;                               // True while loopPlayback() sounds an element
+
+int playbackWpm = 6;                                  // Playback speed in words per minute, 6 WPM gives a 200 ms dot
+const uint8_t playbackFarnsworthWpm = 0;              // Set below playbackWpm to stretch the gaps to this overall speed, 0 for standard spacing
+const int minPlaybackWpm = 2;                         // Slowest playback speed selectable from command mode
+const int maxPlaybackWpm = 30;                        // Fastest playback speed selectable from command mode
+const bool playbackSpeedup = true;                    // Set to false to always play received Morse at playbackWpm
+const uint16_t speedupStartDepth = 16;                // Queued playback items at which playback starts to speed up
+const uint16_t speedupFullDepth = 128;                // Queued playback items at which it reaches speedupMinPercent
+const uint8_t speedupMinPercent = 40;                 // Shortest element and gap in percent of the normal duration
+const uint16_t speedupMinDuration = 50;               // Elements and gaps are never shortened below this (ms)
+
+
+byte keyedCode = MORSE_EMPTY_CODE;                    // Packed code of the character being keyed in character mode
+uint8_t keyedWord[FRAME_MAX_PAYLOAD];                 // Symbols of the word being keyed in character mode
+byte keyedWordLength = 0;                             // Number of symbols in keyedWord
+uint8_t keyedStreamBits[FRAME_MAX_PAYLOAD - VARINT_MAX_SIZE]; // Packed elements of the character being keyed in element stream mode
+ElementStream keyedStream;                            // Element stream over keyedStreamBits
+bool keyedStreamAfterCharacter = false;               // True after a character was sent and no word gap followed yet
+bool keyedStreamStartsWord = false;                   // True if the next element stream starts with a word gap
+unsigned long lastKeyReleaseTime = 0;                 // Time the last element was keyed in character or element stream mode
+
+RxParser radioParser;                                 // Receive state for element lines and frames from the HC-12
+ShellParser shell;                                    // Receive state for commands from the serial monitor
+bool shellAtPending = false;                          // True while an AT command from the serial monitor runs
+bool shellAtBinary = false;                           // True if its reply goes out in binary mode
+bool shellLinkPending = false;                        // True while a link profile switch from the serial monitor runs
+bool shellLinkBinary = false;                         // True if its reply goes out in binary mode
+const unsigned long bridgeIdleTimeout = 10000;        // The AT bridge returns to normal mode after this long without input (ms)
+bool bridgeBinary = false;                            // True if the bridge was opened in binary mode
+#if RADIO_TRACE
+bool traceDumpActive = false;                         // True while the trace is being printed
+bool traceDumpBinary = false;                         // True if it goes out in binary mode
+uint8_t traceDumpNext = 0;                            // Next trace entry to print
+#endif
+bool statsDumpActive = false;                         // True while the statistics are being printed
+byte statsDumpNext = 0;                               // Next line of the statistics to print
+const byte statsHopLine = 24;                         // First of the per channel hopping lines
+const int statsLineRoom = 63;                         // Free serial buffer needed before the next line, the longest one
+
+unsigned long elementsSent = 0;                       // Number of elements sent via HC-12
+unsigned long elementsReceived = 0;                   // Number of valid elements received via HC-12
+unsigned long invalidReceived = 0;                    // Number of messages received via HC-12 that were not an element
+unsigned long framesSent = 0;                         // Number of frames sent via HC-12
+unsigned long framesReceived = 0;                     // Number of valid frames received via HC-12
+unsigned long framesDropped = 0;                      // Number of damaged frames received via HC-12
+unsigned long textSymbolsSent = 0;                    // Number of characters sent in FRAME_TEXT frames
+unsigned long textBytesSent = 0;                      // Number of compressed bytes those characters took
+
+unsigned long playbackDropped = 0;                    // Number of received items that did not fit into the playback queue
+unsigned long txDelayed = 0;                          // Number of messages that waited for credit before being sent
+unsigned long txDropped = 0;                          // Number of messages dropped because the send queue was full
+
+// Flow control: every device advertises the free space of its playback queue in FRAME_CREDIT frames and only sends
+// elements, element streams and text while the other device has room to play them
+const unsigned long creditInterval = 500;             // Advertise changed credit at most this often in milliseconds
+const unsigned long creditRequestTimeout = 2000;      // Ask for credit after waiting this long for it
+const unsigned long creditInFlightTimeout = 2000;     // A message not acknowledged after this long counts as lost
+const uint16_t creditMargin = 8;                      // Playback items held back from the advertised credit
+long remoteCredit = -1;                               // Items the other device can still queue, -1 until it advertised any
+unsigned long lastCreditSent = 0;                     // Time this device last advertised credit
+unsigned long lastCreditReceived = 0;                 // Time credit from the other device last arrived or was requested
+uint16_t creditAdvertised = 0;                        // Free space this device last advertised
+bool creditRequested = false;                         // True if the other device asked for credit
+uint8_t messagesReceived = 0;                         // Paced messages received, wraps, acknowledged in FRAME_CREDIT
+uint8_t messagesSent = 0;                             // Paced messages sent, wraps
+
+// Cost of the latest paced messages, to subtract those still in flight from advertised credit
+const byte sentHistorySize = 8;
+uint16_t sentCost[sentHistorySize];                   // Indexed by messagesSent % sentHistorySize
+unsigned long sentTime[sentHistorySize];
+
+// Paced messages waiting for credit
+struct TxMessage {
+  uint8_t data[FRAME_MAX_SIZE];                       // Element line or frame, ready to write
+  byte length;
+  uint16_t cost;                                      // Playback items the message adds on the other device
+};
+const byte txQueueSize = 3;
+TxMessage txQueue[txQueueSize];
+byte txQueueHead = 0;
+byte txQueueCount = 0;
+
+unsigned long loopbackKeyTime = 0;                    // micros() when the element being timed was keyed in loopback test mode
+bool loopbackKeyPending = false;                      // True until the element keyed at loopbackKeyTime reaches the sounder
+unsigned long loopbackLatencyMin = 0;                 // Shortest keying to sounder latency in microseconds
+unsigned long loopbackLatencyMax = 0;                 // Longest keying to sounder latency in microseconds
+unsigned long loopbackLatencyTotal = 0;               // Sum of all measured latencies in microseconds
+unsigned long loopbackLatencyCount = 0;               // Number of measured latencies
+
+// HC-12 link profiles that can be selected from command mode, both devices must use the same profile
+struct LinkProfile {
+  const char* fuCommand;                              // AT command selecting the transmission mode
+  const char* baudCommand;                            // AT command selecting the serial/air baud rate
+  unsigned long baudRate;                             // Serial baud rate to use with the module afterwards
+};
+
+const LinkProfile linkProfiles[] = {
+  {"AT+FU3", "AT+B9600", 9600},                       // Module default, general purpose
+  {"AT+FU1", "AT+B9600", 9600},                       // Power saving mode
+  {"AT+FU2", "AT+B4800", 4800},                       // Power saving mode, low baud rates only
+  {"AT+FU4", "AT+B1200", 1200},                       // Long range, 1200 baud only
+};
+const byte linkProfileCount = sizeof(linkProfiles) / sizeof(linkProfiles[0]);
+byte linkProfileIndex = 0;                            // Index of the link profile in use
+byte linkSwitchProfile = linkProfileCount;            // Profile loopLinkSwitch() is switching to, linkProfileCount if none
+bool linkSwitchBaud = false;                          // True once the transmission mode is set and the baud rate is next
+
+// Throughput benchmark, the first payload byte of a FRAME_BENCHMARK frame is one of these
+const uint8_t BENCHMARK_PROFILE = 1;                  // Switch to linkProfiles[payload[1]]
+const uint8_t BENCHMARK_START = 2;                    // Mute the sounder and count received elements
+const uint8_t BENCHMARK_END = 3;                      // Stop counting, unmute and reply with BENCHMARK_REPORT
+const uint8_t BENCHMARK_REPORT = 4;                   // payload[1..2] elements counted, payload[3..6] ms from first to last
+const uint16_t benchmarkElementCount = 300;           // Elements streamed per link profile
+const unsigned long benchmarkReportTimeout = 3000;    // Time to wait for the report in milliseconds
+const unsigned long benchmarkFrameTime = 100;         // Time a benchmark frame needs to leave before this module is reconfigured
+const unsigned long benchmarkSettleTime = 500;        // Time the other device gets to switch profiles in milliseconds
+const byte benchmarkNoProfile = 0xFF;
+
+// Steps of a throughput benchmark run by loopThroughputBenchmark()
+const byte BENCH_IDLE = 0;                            // No benchmark running on this device
+const byte BENCH_REQUEST = 1;                         // Ask the other device to switch to the next profile
+const byte BENCH_SWITCH = 2;                          // Switch this device once the request has left
+const byte BENCH_SETTLE = 3;                          // Wait until both devices are done switching
+const byte BENCH_STREAM = 4;                          // Stream the element lines
+const byte BENCH_REPORT = 5;                          // Wait for the other device's report
+
+bool benchmarkReceiving = false;                      // True between BENCHMARK_START and BENCHMARK_END, the sounder is muted
+uint16_t benchmarkReceived = 0;                       // Elements counted since BENCHMARK_START
+unsigned long benchmarkFirstTime = 0;                 // Time the first counted element arrived
+unsigned long benchmarkLastTime = 0;                  // Time the last counted element arrived
+byte benchmarkProfileRequest = benchmarkNoProfile;    // Profile to switch to, requested by the other device
+bool benchmarkReportRequested = false;                // True if the other device waits for a report
+bool benchmarkReportReady = false;                    // True once the other device's report arrived
+uint16_t benchmarkReportCount = 0;                    // Elements the other device counted
+unsigned long benchmarkReportElapsed = 0;             // Time between its first and last counted element in milliseconds
+byte benchmarkStep = BENCH_IDLE;                      // Step of the benchmark running on this device
+byte benchmarkProfile = 0;                            // Profile being measured, linkProfileCount while restoring the one before
+byte benchmarkOriginalProfile = 0;                    // Profile in use before the benchmark started
+uint16_t benchmarkSent = 0;                           // Element lines streamed at the current profile
+unsigned long benchmarkStepTime = 0;                  // Time the current step started
+unsigned long benchmarkSendTime = 0;                  // Time the element lines took to stream in milliseconds
 
 
 /*
-@brief Function to beep the buzzer and LED at the same time
+@brief Function to beep the buzzer and LED at the same time, loopBeep() sounds the beeps without blocking
+@details A pattern that is still sounding is replaced.
 @param _times Number of times to beep
 @param _duration Duration of each beep in milliseconds
 */
 void beepAndBuzz (int _times, int _duration) {
-  for (int i = 0; i < _times; i++) {
-    digitalWrite(BUZZER_PIN, HIGH);
-    digitalWrite(LED_PIN, HIGH);
-    delay(_duration);
+  if (beepOn && !sounderOn) {
     digitalWrite(BUZZER_PIN, LOW);
     digitalWrite(LED_PIN, LOW);
-    delay(200); // Delay between beeps
+  }
+  beepsLeft = _times;
+  beepDuration = _duration;
+  beepOn = false;
+  beepTime = millis() - beepPause;                    // The first beep starts right away
+}
+
+/*
+@brief Function to switch the beeps of beepAndBuzz() on and off, call once per loop
+@note The buzzer and LED are shared with loopPlayback(), each only switches them off if the other is not sounding.
+*/
+void loopBeep() {
+  unsigned long elapsed = millis() - beepTime;
+
+  if (beepOn) {
+    if (elapsed >= beepDuration) {
+      if (!sounderOn) {
+        digitalWrite(BUZZER_PIN, LOW);
+        digitalWrite(LED_PIN, LOW);
+      }
+      beepOn = false;
+      beepTime += elapsed;
+    }
+  } else if (beepsLeft > 0 && elapsed >= beepPause) {
+    digitalWrite(BUZZER_PIN, HIGH);
+    digitalWrite(LED_PIN, HIGH);
+    beepOn = true;
+    beepsLeft--;
+    beepTime += elapsed;
+  }
+}
+
+/*
+*@brief Function to read the Morse key
+*@return True while the button is pressed, or the key script holds the key down when scriptedKeying is set
+*/
+bool keyDown() {
+  if (scriptedKeying) {
+    return keyScriptDown(millis());
+  }
+  return digitalRead(BUTTON_PIN) == LOW;
+}
+
+/*
+*@brief Function to start key scripts typed into the serial monitor, one line of durations per script
+*/
+void loopKeyScript() {
+  while (Serial.available()) {
+    if (keyScriptFeed(Serial.read())) {
+      Serial.println(F("Key script started."));
+    }
   }
 }
 
@@ -79,16 +391,16 @@ void loopBuzzerLedAndButtonTest() {
 
 void setupHcTestMode() {
   if (!hcTestMode){
-    Serial.println("HC-12 is in normal mode.");
+    Serial.println(F("HC-12 is in normal mode."));
   } else {
-    Serial.println("HC-12 is in configuration mode. Please set the parameters as needed.");
+    Serial.println(F("HC-12 is in configuration mode. Please set the parameters as needed."));
     if (isInitiator) {
       delay(1000); // Wait for HC-12 to initialize
-      Serial.println("This device is the initiator of the communication.");
-      morse.println("1"); // Send a message to the other device
+      Serial.println(F("This device is the initiator of the communication."));
+      morse.println(F("1")); // Send a message to the other device
       delay(1000); // Wait for a second before sending the next message
     } else {
-      Serial.println("This device is not the initiator of the communication.");
+      Serial.println(F("This device is not the initiator of the communication."));
     }
   }
 }
@@ -99,12 +411,12 @@ void loopHcTestMode() {
       String message = morse.readStringUntil('\n');
       hc12TestValue = message.toInt();
 
-      Serial.print("Received: ");
+      Serial.print(F("Received: "));
       Serial.print(hc12TestValue);
 
       if (hc12TestValue > 0) {
         int replyValue = hc12TestValue + 1;
-        Serial.print("\tSent: ");
+        Serial.print(F("\tSent: "));
         Serial.println(replyValue);
         delay(500); // Wait for 500 ms before sending the reply
         morse.println(replyValue);
@@ -123,155 +435,2107 @@ bool setupHc12() {
 
   delay(1000);                                            // Let the module initialize
 
-  morse.println("AT");                                    // Send "AT" command to HC-12 to check if functional
+  morse.println(F("AT"));                                    // Send "AT" command to HC-12 to check if functional
   delay(100);                                             // Brief pause to ensure Serial message is sent and response is received
 
   if (morse.available()) {
     String response = morse.readStringUntil('\n');        // Read response from HC-12 module and print to serial monitor
-    Serial.print("HC-12 Response: ");
+    Serial.print(F("HC-12 Response: "));
     Serial.println(response);
 
     digitalWrite(HC12_SET_PIN, HIGH);                     // Switch to normal mode
 
     if (response.startsWith("OK")) {                      // Return True if response is "OK"
-      Serial.println("HC-12 is ready for configuration.");
+      Serial.println(F("HC-12 is ready for configuration."));
       return true;
     } else {
-      Serial.println("Failed to configure HC-12.");       // Return False if "OK" response is not received
+      Serial.println(F("Failed to configure HC-12."));       // Return False if "OK" response is not received
       return false;
     }
   } else {
-    Serial.println("No response from HC-12.");
+    Serial.println(F("No response from HC-12."));
     digitalWrite(HC12_SET_PIN, HIGH);                     // Switch to normal mode
     return false;
   }
 }
 
 /*
-*@brief Function to beep the buzzer and LED for a specific duration based on the morse code received
-*@param _isDot True for dot, false for dash
+*@brief Function to add one keying to sounder latency to the loopback statistics and print it
+*@param _latency Time from the key release to the start of playback in microseconds
+*/
+void recordLoopbackLatency(unsigned long _latency) {
+  if (loopbackLatencyCount == 0 || _latency < loopbackLatencyMin) {
+    loopbackLatencyMin = _latency;
+  }
+  if (_latency > loopbackLatencyMax) {
+    loopbackLatencyMax = _latency;
+  }
+  loopbackLatencyTotal += _latency;
+  loopbackLatencyCount++;
+
+  Serial.print(F("Loopback Latency (us): "));
+  Serial.println(_latency);
+}
+
+/*
+*@brief Function to queue one element or gap for playback on the buzzer and LED
+*@param _item One of the ELEMENT_* items
 */
-void outBeepAndBuzz(bool _isDot) {
-  beepAndBuzz(1, _isDot ? dotDuration : dashDuration);           // Beep once for dot, twice for dash
-  delay(morseInterval);
+void queuePlayback(uint8_t _item) {
+  if (!playbackPush(_item)) {
+    playbackDropped++;
+  }
 }
 
+/*
+*@brief Function to drive the buzzer and LED from the playback queue, call once per loop
+*/
+void loopPlayback() {
+  switch (playbackUpdate(millis())) {
+    case PLAYBACK_ON:
+      if (loopbackTestMode && loopbackKeyPending) {
+        recordLoopbackLatency(micros() - loopbackKeyTime);
+        loopbackKeyPending = false;
+      }
+      PROBE_SOUNDER_ON();
+      digitalWrite(BUZZER_PIN, HIGH);
+      digitalWrite(LED_PIN, HIGH);
+      sounderOn = true;
+      break;
+    case PLAYBACK_OFF:
+      if (!beepOn) {                                  // A beep keeps sounding until loopBeep() ends it
+        digitalWrite(BUZZER_PIN, LOW);
+        digitalWrite(LED_PIN, LOW);
+      }
+      sounderOn = false;
+      break;
+    default:
+      break;
+  }
+}
 
 void morseBeepAndBuzz(int _value) {
   if (_value == 1){
-    outBeepAndBuzz(true); // Dot
+    queuePlayback(ELEMENT_DOT);
   } else if (_value == 2) {
-    outBeepAndBuzz(false); // Dash
+    queuePlayback(ELEMENT_DASH);
   } else {
-    Serial.println("Invalid morse value. Please send 1 for dot or 2 for dash.");
+    Serial.println(F("Invalid morse value. Please send 1 for dot or 2 for dash."));
   }
 }
 
-int talkMorse() {
-  int _morseToSend = 0;
-  bool dashBeeped = false;
+/*
+*@brief Function to print a codec symbol to the serial monitor, prosigns are printed as <AR>
+*/
+void printSymbol(uint8_t _symbol) {
+  char name[3];
 
-  if (digitalRead(BUTTON_PIN) == LOW) {
-    lastButtonPressTime = millis();
+  if (morseProsignName(_symbol, name)) {
+    Serial.print(F("<"));
+    Serial.print(name);
+    Serial.print(F(">"));
+  } else {
+    Serial.print((char)_symbol);
+  }
+}
 
-    while (digitalRead(BUTTON_PIN) == LOW) {
-      unsigned long holdDuration = millis() - lastButtonPressTime;
+/*
+*@brief Function to queue one character or prosign for playback
+*@details The elements are followed by a character gap that marks the end of the character.
+*/
+void playSymbol(uint8_t _symbol) {
+  uint8_t code = morseEncode(_symbol);
 
-      // 🔊 Beep once when dash threshold is reached
-      if (!dashBeeped && holdDuration > 1000) {
-        digitalWrite(LED_PIN, HIGH);
-        digitalWrite(BUZZER_PIN, HIGH);
-        delay(100); // Short beep
-        digitalWrite(BUZZER_PIN, LOW);
-        digitalWrite(LED_PIN, LOW);
-        dashBeeped = true;
-      }
+  for (int8_t i = morseCodeLength(code) - 1; i >= 0; i--) {
+    queuePlayback(((code >> i) & 1) == 0 ? ELEMENT_DOT : ELEMENT_DASH);
+  }
+  queuePlayback(ELEMENT_CHARACTER_GAP);
+}
+
+/*
+*@brief Function to count the playback items text adds on the receiving device, see playText()
+*/
+uint16_t textPlaybackCost(const uint8_t* _text, byte _length) {
+  uint16_t cost = 1;                                      // Word gap after the last word
+
+  for (byte i = 0; i < _length; i++) {
+    cost += _text[i] == ' ' ? 1 : morseCodeLength(morseEncode(_text[i])) + 1;
+  }
+  return cost;
+}
+
+/*
+*@brief Function to queue received text for playback
+*@param _data Compressed text from a FRAME_TEXT frame
+*@param _length Number of compressed bytes
+*/
+void playText(const uint8_t* _data, byte _length) {
+  uint8_t text[FRAME_MAX_PAYLOAD * TEXT_MAX_WORD_LENGTH];
+  byte textLength = textExpand(_data, _length, text, sizeof(text));
+
+  if (textLength == 0) {
+    Serial.println(F("Invalid text received."));
+    invalidReceived++;
+    return;
+  }
+
+  Serial.print(F("Text Received: "));
+  for (byte i = 0; i < textLength; i++) {
+    printSymbol(text[i]);
+  }
+  Serial.println();
+
+  for (byte i = 0; i < textLength; i++) {
+    if (text[i] == ' ') {
+      queuePlayback(ELEMENT_WORD_GAP);                    // Word gap on top of the character gap
+    } else {
+      playSymbol(text[i]);
     }
+  }
+  queuePlayback(ELEMENT_WORD_GAP);                        // Word gap after the last word
+}
+
+/*
+*@brief Function to queue a received element stream for playback
+*@param _data Serialized element stream from a FRAME_ELEMENTS frame
+*@param _length Number of bytes
+*/
+void playElementStream(const uint8_t* _data, byte _length) {
+  const uint8_t* bits;
+  uint16_t count = elementStreamDecode(_data, _length, &bits);
 
-    delay(50); // Small debounce after release
+  if (count == 0) {
+    Serial.println(F("Invalid element stream received."));
+    invalidReceived++;
+    return;
+  }
 
-    unsigned long pressDuration = millis() - lastButtonPressTime;
+  Serial.print(F("Elements Received: "));
+  Serial.println(count);
 
-    if (pressDuration > 100 && pressDuration <= 1000) {
-      _morseToSend = 1; // Dot
-    } else if (pressDuration > 1000) {
-      _morseToSend = 2; // Dash
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t item = elementStreamItem(bits, i);
+    if (item == ELEMENT_DOT || item == ELEMENT_DASH) {
+      elementsReceived++;
     }
+    queuePlayback(item);
+  }
+}
+
+/*
+*@brief Function to act on a FRAME_BENCHMARK frame
+*@details Counting starts and stops right away, switching profiles and replying are left to loopBenchmark().
+*/
+void handleBenchmarkFrame(const Frame& _frame) {
+  if (_frame.length == 0) {
+    invalidReceived++;
+    return;
   }
 
-  return _morseToSend;
+  switch (_frame.payload[0]) {
+    case BENCHMARK_PROFILE:
+      if (_frame.length >= 2 && _frame.payload[1] < linkProfileCount) {
+        benchmarkProfileRequest = _frame.payload[1];
+      }
+      break;
+    case BENCHMARK_START:
+      benchmarkReceiving = true;
+      benchmarkReceived = 0;
+      break;
+    case BENCHMARK_END:
+      benchmarkReceiving = false;
+      benchmarkReportRequested = true;
+      break;
+    case BENCHMARK_REPORT:
+      if (_frame.length >= 7) {
+        benchmarkReportCount = _frame.payload[1] | (uint16_t)_frame.payload[2] << 8;
+        benchmarkReportElapsed = 0;
+        for (byte i = 0; i < 4; i++) {
+          benchmarkReportElapsed |= (unsigned long)_frame.payload[3 + i] << (8 * i);
+        }
+        benchmarkReportReady = true;
+      }
+      break;
+    default:
+      invalidReceived++;
+      break;
+  }
 }
 
 /*
-* @brief Function to setup IO pins for button, LED and buzzer
+*@brief Function to add up the cost of paced messages the other device has not acknowledged yet
+*@param _acknowledged Number of paced messages the other device received, wraps
 */
-void setupIoPins() {
-  pinMode(BUTTON_PIN, INPUT_PULLUP);                     // Set button pin as input with pull-up resistor
-  pinMode(LED_PIN, OUTPUT);                              // Set LED pin as output
-  pinMode(BUZZER_PIN, OUTPUT);                           // Set buzzer pin as output
+uint16_t creditInFlight(uint8_t _acknowledged) {
+  uint8_t unacknowledged = messagesSent - _acknowledged;
+  uint16_t cost = 0;
 
-  digitalWrite(LED_PIN, LOW);                            // Ensure LED is off at startup
-  digitalWrite(BUZZER_PIN, LOW);                         // Ensure buzzer is off at startup
+  for (uint8_t i = 0; i < unacknowledged && i < sentHistorySize; i++) {
+    uint8_t index = (uint8_t)(messagesSent - 1 - i) % sentHistorySize;
+    if (millis() - sentTime[index] < creditInFlightTimeout) {   // Older ones were lost
+      cost += sentCost[index];
+    }
+  }
+  return cost;
+}
 
-  Serial.println("-----------------------------------");
-  Serial.println("IO Pins Initialized");
-  Serial.print("Button Pin: ");
-  Serial.println(BUTTON_PIN);
-  Serial.print("LED Pin: ");
-  Serial.println(LED_PIN);
-  Serial.print("Buzzer Pin: ");
-  Serial.println(BUZZER_PIN);
-  Serial.println("-----------------------------------");
+/*
+*@brief Function to act on a FRAME_CREDIT frame
+*@details An empty frame asks for credit, otherwise payload[0..1] is the free playback space of the other device and
+*         payload[2] the number of paced messages it received.
+*/
+void handleCreditFrame(const Frame& _frame) {
+  if (_frame.length == 0) {
+    creditRequested = true;
+    return;
+  }
+  if (_frame.length < 3) {
+    invalidReceived++;
+    return;
+  }
+
+  long advertised = _frame.payload[0] | (uint16_t)_frame.payload[1] << 8;
+  remoteCredit = advertised - creditInFlight(_frame.payload[2]);
+  lastCreditReceived = millis();
+}
+
+/*
+*@brief Function to act on a FRAME_HOP beacon
+*@details payload[0..3] is the sender's slot number and payload[4..5] the milliseconds since that slot started.
+*         From the initiator, payload[6..7] is the skip mask in effect and payload[8..9] the one that takes effect
+*         payload[10] slots later. From the follower, payload[6..7] are the channels it measured as bad.
+*/
+void handleHopFrame(const Frame& _frame) {
+  if (_frame.length < 11) {
+    invalidReceived++;
+    return;
+  }
+#if FREQUENCY_HOPPING
+  uint32_t slot = 0;
+  for (byte i = 0; i < 4; i++) {
+    slot |= (uint32_t)_frame.payload[i] << (8 * i);
+  }
+  uint16_t elapsed = _frame.payload[4] | (uint16_t)_frame.payload[5] << 8;
+  uint16_t mask = _frame.payload[6] | (uint16_t)_frame.payload[7] << 8;
+
+  hopBeaconReceived = true;
+  hopPeerHeard = true;
+  if (isInitiator) {
+    hopPeerBad = mask;
+    hopLastHeard = hopSlot;
+    return;
+  }
+
+  hopSlot = slot;                                         // Follow the initiator's clock
+  hopSlotStart = millis() - elapsed - hopBeaconLatency;
+  hopLastHeard = slot;
+  hopSetSkipMask(hopSchedule, mask);
+  hopNextSkip = _frame.payload[8] | (uint16_t)_frame.payload[9] << 8;
+  hopNextSkipSlot = slot + _frame.payload[10];
+  if (!hopSynced) {
+    hopSynced = true;
+    hopIndex = hopChannelIndex(hopSchedule, hopSlot);     // The channel the beacon was just heard on
+    Serial.println(F("Hopping: in sync."));
+  }
+  hopReplyDue = true;
+#endif
 }
 
+/*
+*@brief Function to act on a valid frame received from the HC-12
+*/
+void handleFrame(const Frame& _frame) {
+  if (_frame.length > FRAME_MAX_PAYLOAD) {                // Only FRAME_SECURE is longer, and it is opened first
+    invalidReceived++;
+    return;
+  }
 
-void setup() {
-  Serial.begin(9600);                                 // Start Serial communication for debugging
-  setupIoPins();                                      // Setup IO pins for button, LED and buzzer
-  setupHcTestMode();
+  switch (_frame.type) {
+    case FRAME_TEXT:
+      messagesReceived++;
+      playText(_frame.payload, _frame.length);
+      break;
+    case FRAME_ELEMENTS:
+      messagesReceived++;
+      playElementStream(_frame.payload, _frame.length);
+      break;
+    case FRAME_CREDIT:
+      handleCreditFrame(_frame);
+      break;
+    case FRAME_BENCHMARK:
+      handleBenchmarkFrame(_frame);
+      break;
+    case FRAME_HOP:
+      handleHopFrame(_frame);
+      break;
+    default:
+      invalidReceived++;
+      break;
+  }
+}
 
+/*
+*@brief Function to act on a received element, from an element line or a sealed FRAME_LINE
+*/
+void receiveElement(int _value) {
+  if (benchmarkReceiving) {                               // Count silently
+    benchmarkLastTime = millis();
+    if (benchmarkReceived++ == 0) {
+      benchmarkFirstTime = benchmarkLastTime;
+    }
+    return;
+  }
+  morseReceived = _value;
+  Serial.print(F("Morse Received: "));
+  Serial.println(morseReceived);
+  elementsReceived++;
+  messagesReceived++;
+  morseBeepAndBuzz(morseReceived);                        // Queue the corresponding beep and buzz for the received morse code
+}
 
-  // Initialize HC-12 module
-  if(setupHc12()) {                                   // If HC-12 setup is successful beep and buzz for 200 milliseconds for 5 times
-    Serial.println("HC-12 setup successful.");
-    beepAndBuzz(5, 200);
-  } else {                                            // If HC-12 setup fails beep and buzz for 3 seconds three time 
-    beepAndBuzz(3, 3000);                               
-    Serial.println("HC-12 setup failed.");
+#if SECURE_FRAMES
+/*
+*@brief Function to mark a counter from the other device as used and raise the receive floor in EEPROM once a batch
+*/
+void acceptCounter(uint32_t _counter) {
+  uint32_t floor = replayFloorAfter(replayFloorSaved, _counter);
+
+  replayAccept(replayWindow, _counter);
+  if (floor != replayFloorSaved) {
+    replayFloorSaved = floor;
+    keyStoreSaveReceiveFloor(replayFloorSaved);
+  }
+}
+
+/*
+*@brief Function to check and decrypt a received frame with SECURE_FRAMES and act on the frame inside
+*@details Frames that are not FRAME_SECURE, come from this device or carry a counter that was already used are dropped
+*         before they are decrypted, then those that fail the tag check. A replay also makes this device send its
+*         receive floor, in case the other device is behind it after this one was reset.
+*/
+void receiveSecureFrame(const Frame& _frame) {
+  if (_frame.type != FRAME_SECURE || !linkKeyLoaded || _frame.length < FRAME_SECURE_OVERHEAD) {
+    secureRejected++;
+    return;
+  }
+
+  uint32_t counter = 0;
+  for (byte i = 0; i < 4; i++) {
+    counter |= (uint32_t)_frame.payload[i] << (8 * i);
+  }
+  if (((counter & SECURE_SENDER_BIT) != 0) == isInitiator) {   // Sent by this device, reflected back
+    secureRejected++;
+    traceRecord(millis(), TRACE_REJECTED, 'S');
+    return;
+  }
+  if (!replayCheck(replayWindow, counter & ~SECURE_SENDER_BIT)) {
+    replayRejected++;
+    counterSyncDue = true;
+    traceRecord(millis(), TRACE_REJECTED, 'R');
+    return;
   }
 
+  Frame inner;
+  if (!secureOpen(linkKey, _frame.payload, _frame.length, &counter, inner)) {
+    secureRejected++;
+    traceRecord(millis(), TRACE_REJECTED, 'A');
+    return;
+  }
+  acceptCounter(counter & ~SECURE_SENDER_BIT);
+
+  if (inner.type == FRAME_COUNTER) {                      // The other device was reset and accepts nothing below this
+    if (inner.length < 4) {
+      invalidReceived++;
+      return;
+    }
+    uint32_t floor = 0;
+    for (byte i = 0; i < 4; i++) {
+      floor |= (uint32_t)inner.payload[i] << (8 * i);
+    }
+    if ((int32_t)(floor - secureCounter) > 0) {
+      secureCounter = floor;
+    }
+    return;
+  }
+  if (inner.type == FRAME_LINE) {
+    if (inner.length == 1 && (inner.payload[0] == '1' || inner.payload[0] == '2')) {
+      receiveElement(inner.payload[0] - '0');
+    } else {
+      invalidReceived++;
+    }
+    return;
+  }
+  handleFrame(inner);
 }
+#endif
 
+/*
+*@brief Function to check if received bytes are waiting, first those a channel switch kept, then the HC-12 buffer
+*@details The HC-12 buffer is not touched while a channel switch or AT command owns the port.
+*/
+bool radioAvailable() {
+  return channelSwitchPending() > 0 || (!channelSwitchBusy() && radio.available());
+}
 
+/*
+*@brief Function to read the next received byte, only if radioAvailable()
+*/
+uint8_t radioRead() {
+  return channelSwitchPending() > 0 ? channelSwitchRead() : radio.read();
+}
 
-void loop() {
-  loopBuzzerLedAndButtonTest();                                        // Test buzzer, LED and button functionality if enabled
-  loopHcTestMode();                                                    // Loop for HC-12 test mode if enabled      
+/*
+*@brief Function to feed the bytes waiting in the HC-12 buffer into the receive parser and act on the first message
+*@details Never waits for more bytes, a partial line or frame is completed on a later call.
+*/
+void receiveRadio() {
+  while (radioAvailable()) {
+    if (!rxParserBusy(radioParser)) {
+      PROBE_RX_FIRST_BYTE();                              // First byte of a line or frame
+    }
 
-  // Priority is listen mode, button cannot be pressed while receiving morse code from other devices
-  // System is designed to receive morse code from other devices and send morse code when button is pressed
-  // Where 1 is dot and 2 is dash
-  // If morse code is received, it will be beeped and buzzed
-  if (morse.available()) {
-    String message = morse.readStringUntil('\n');                       // Get message from HC-12 module and print to serial monitor
-    Serial.print("Received: ");
-    Serial.println(message);
+    uint8_t event = rxParserFeed(radioParser, radioRead());
+    if (event == RX_ELEMENT || event == RX_FRAME) {
+      PROBE_PARSED();
+      traceRecord(millis(), TRACE_RX, event == RX_ELEMENT ? radioParser.line[0] : radioParser.frame.frame.type);
+    } else if (event == RX_FRAME_ERROR) {
+      traceRecord(millis(), TRACE_RX_ERROR, 0);
+    }
+
+    switch (event) {
+      case RX_ELEMENT:
+#if SECURE_FRAMES
+        secureRejected++;                                 // Anyone could have sent it
+        break;
+#endif
+        if (!benchmarkReceiving) {
+          Serial.print(F("Received: "));
+          Serial.println(radioParser.line);
+        }
+        receiveElement(radioParser.element);
+        if (benchmarkReceiving) {                         // Keep draining the buffer
+          break;
+        }
+        return;
+      case RX_FRAME:
+        framesReceived++;
+#if SECURE_FRAMES
+        receiveSecureFrame(radioParser.frame.frame);
+#else
+        handleFrame(radioParser.frame.frame);             // Binary frame, e.g. a word sent in character mode
+#endif
+        return;
+      case RX_FRAME_ERROR:
+        framesDropped++;
+        break;
+      case RX_INVALID:
+        Serial.print(F("Received: "));
+        Serial.println(radioParser.line);
+        invalidReceived++;
+        return;
+      default:
+        break;
+    }
+  }
+}
+
+#if SECURE_FRAMES
+/*
+*@brief Function to take the next send counter, reserving a new batch in EEPROM when the last one is used up
+*/
+uint32_t nextSecureCounter() {
+  uint32_t reserved = replayReserve(secureCounterReserved, secureCounter);
+
+  if (reserved != secureCounterReserved) {
+    secureCounterReserved = reserved;
+    keyStoreSaveSendCounter(secureCounterReserved);         // After a reset counting resumes from here
+  }
+  return secureCounter++;
+}
 
-    morseReceived = message.toInt();                                    // Convert the received message to an integer, if it is not a valid integer, it will be 0
+/*
+*@brief Function to seal an element line or frame into a FRAME_SECURE frame with the link key
+*@param _out Receives the sealed frame, at least FRAME_MAX_SIZE bytes
+*@return Size of the sealed frame, 0 without a link key
+*/
+byte sealBurst(const uint8_t* _data, byte _length, uint8_t* _out) {
+  if (!linkKeyLoaded) {
+    return 0;
+  }
 
-    if(morseReceived > 0) {                                             // If the received message is greater than 0, it is a valid morse code
-      Serial.print("Morse Received: ");
-      Serial.println(morseReceived);
-      morseBeepAndBuzz(morseReceived);                                  // Perform corresponding beep and buzz for the received morse code
+  uint8_t type = FRAME_LINE;
+  const uint8_t* payload = _data;
+  byte payloadLength = 0;
+  if (_data[0] == FRAME_START) {                          // Frame, seal its type and payload
+    type = _data[1];
+    payload = _data + 3;
+    payloadLength = _data[2];
+  } else {                                                // Element line, seal it without the line end
+    while (payloadLength < _length && _data[payloadLength] != '\r' && _data[payloadLength] != '\n') {
+      payloadLength++;
     }
+  }
+
+  uint32_t counter = nextSecureCounter() | (isInitiator ? SECURE_SENDER_BIT : 0);
+  uint8_t sealed[FRAME_MAX_WIRE_PAYLOAD];
+  byte sealedLength = secureSeal(linkKey, counter, type, payload, payloadLength, sealed);
+
+  return frameEncode(FRAME_SECURE, sealed, sealedLength, _out);
+}
+#endif
+
+/*
+*@brief Function to print an AT command and the first line of the HC-12's reply to it
+*/
+void printAtReply(const char* _command, const char* _reply) {
+  Serial.print(_command);
+  Serial.print(F(" -> "));
+  if (_reply[0] == '\0') {
+    Serial.println(F("No response from HC-12."));
+    return;
+  }
+  while (*_reply != '\0' && *_reply != '\n') {
+    Serial.print(*_reply++);
+  }
+  Serial.println();
+}
+
+/*
+*@brief Function to check if a link profile switch is running
+*/
+bool linkSwitchBusy() {
+  return linkSwitchProfile < linkProfileCount;
+}
+
+/*
+*@brief Function to start switching the HC-12 to one of the linkProfiles, loopLinkSwitch() finishes it
+*@details Both AT commands run through channel_switch.h one after the other, so the loop keeps running meanwhile.
+*         Nothing is sent until the switch is done, see radioClear(). Only call while channelSwitchBusy() is false.
+*@param _index Index into linkProfiles
+*/
+void startLinkProfile(byte _index) {
+  const char* command = linkProfiles[_index].fuCommand;
+
+  if (channelScanMode) {
+    channelScanHold();                                    // Stay on this channel
+  }
+  linkSwitchProfile = _index;
+  linkSwitchBaud = false;
+  channelSwitchCommand(command, strlen(command), millis());
+}
+
+/*
+*@brief Function to advance a link profile switch, call once per loop
+*/
+void loopLinkSwitch() {
+  if (!linkSwitchBusy()) {
+    return;
+  }
+  channelSwitchPoll(millis());
+  if (channelSwitchBusy()) {
+    return;
+  }
+
+  const LinkProfile& profile = linkProfiles[linkSwitchProfile];
+  if (!linkSwitchBaud) {
+    printAtReply(profile.fuCommand, channelSwitchReply());
+    linkSwitchBaud = true;
+    channelSwitchCommand(profile.baudCommand, strlen(profile.baudCommand), millis());
+    return;
+  }
+
+  printAtReply(profile.baudCommand, channelSwitchReply());
+  morse.begin(profile.baudRate);                          // The module uses the new rate once back in normal mode
+#if LOOPBACK_TEST
+  loopback.begin(profile.baudRate);                       // Keep the simulated link at the same rate
+#endif
+  linkProfileIndex = linkSwitchProfile;
+  linkSwitchProfile = linkProfileCount;
+}
+
+/*
+*@brief Function to write one burst of bytes to the radio, sealed with SECURE_FRAMES and through the fault
+*       injector if it is enabled
+*@details Only call while radioClear(), during a hop or AT command the bytes would go to the module. Callers that
+*         find it busy try again on a later loop, this never waits for the HC-12.
+*/
+void radioWrite(const uint8_t* _data, byte _length) {
+  if (channelScanMode) {
+    channelScanHold();                                // Stay where the other device listens
+  }
+  traceRecord(millis(), TRACE_TX, _data[0] == FRAME_START ? _data[1] : _data[0]);
+#if SECURE_FRAMES
+  uint8_t sealed[FRAME_MAX_SIZE];
+  _length = sealBurst(_data, _length, sealed);
+  _data = sealed;
+#endif
+  if (faultInjectionEnabled) {
+    uint8_t damaged[2 * FRAME_MAX_SIZE];
+    uint16_t size = faultApply(radioFaults, _data, _length, damaged);
+    PROBE_TX_FIRST_BYTE();
+    radio.write(damaged, size);
   } else {
-    //Listen for button press if no morse code is available to output
+    PROBE_TX_FIRST_BYTE();
+    radio.write(_data, _length);
+  }
+}
+
+/*
+*@brief Function to send a frame via HC-12 right away, for control frames that are not paced
+*@details Only call while radioClear(), see radioWrite().
+*/
+void sendFrame(uint8_t _type, const uint8_t* _payload, byte _length) {
+  uint8_t buffer[FRAME_MAX_SIZE];
+  byte size = frameEncode(_type, _payload, _length, buffer);
+
+  PROBE_QUEUED();
+  radioWrite(buffer, size);
+  framesSent++;
+}
+
+/*
+*@brief Function to check if anything may be sent now, every caller of radioWrite() and sendFrame() checks it first
+*@details Nothing is started while the HC-12 is in configuration mode, for an AT command, the AT bridge, a channel
+*         switch or a link profile switch. Paced messages wait in the send queue, control frames are sent by their
+*         loop function on a later pass. While hopping nothing is started within hopGuard of the next hop either, so
+*         no frame is cut off by a hop.
+*/
+bool radioClear() {
+  if (channelSwitchBusy() || linkSwitchBusy()) {
+    return false;
+  }
+#if FREQUENCY_HOPPING
+  return millis() - hopSlotStart < hopSlotLength - hopGuard;
+#else
+  return true;
+#endif
+}
+
+#if SECURE_FRAMES
+/*
+*@brief Function to tell the other device the lowest counter this device accepts from it, call once per loop
+*/
+void loopCounterSync() {
+  if (!counterSyncDue || millis() - lastCounterSync < counterSyncInterval || !radioClear()) {
+    return;
+  }
+
+  uint32_t next = replayNext(replayWindow);
+  uint8_t payload[4] = {(uint8_t)next, (uint8_t)(next >> 8), (uint8_t)(next >> 16), (uint8_t)(next >> 24)};
+  sendFrame(FRAME_COUNTER, payload, sizeof(payload));
+  counterSyncDue = false;
+  lastCounterSync = millis();
+}
+#endif
+
+#if FREQUENCY_HOPPING
+/*
+*@brief Function to send a FRAME_HOP beacon, see handleHopFrame()
+*/
+void sendHopBeacon() {
+  uint16_t elapsed = millis() - hopSlotStart;
+  uint16_t mask = isInitiator ? hopSchedule.skipMask : hopSchedule.badMask;
+  uint16_t next = isInitiator ? hopNextSkip : 0;
+  uint8_t lead = isInitiator && (int32_t)(hopNextSkipSlot - hopSlot) > 0 ? hopNextSkipSlot - hopSlot : 0;
+  uint8_t payload[11] = {(uint8_t)hopSlot, (uint8_t)(hopSlot >> 8), (uint8_t)(hopSlot >> 16), (uint8_t)(hopSlot >> 24),
+                         (uint8_t)elapsed, (uint8_t)(elapsed >> 8), (uint8_t)mask, (uint8_t)(mask >> 8),
+                         (uint8_t)next, (uint8_t)(next >> 8), lead};
+
+  sendFrame(FRAME_HOP, payload, sizeof(payload));
+}
+
+/*
+*@brief Function to pick the channel of the current slot
+*@details Until it is in sync, the follower parks on one channel for two cycles, long enough for the initiator to
+*         visit every channel, before it tries the next.
+*/
+uint8_t hopTuneChannel() {
+  if (hopSynced) {
+    hopIndex = hopChannelIndex(hopSchedule, hopSlot);
+  } else {
+    hopIndex = hopSlot / (2 * hopSchedule.count) % hopSchedule.count;
+  }
+  return hopSchedule.channels[hopIndex];
+}
+
+/*
+*@brief Function to hop to the next channel at the end of every slot and exchange beacons, call once per loop
+*@details The next channel is tuned right at the slot boundary without blocking, and only if it differs from the
+*         current one. While an AT command, link profile switch or switch runs the hop is deferred by one slot, so its
+*         reply is not taken for the hop's. The initiator sends its beacon once both devices are done switching and the follower answers
+*         every beacon it hears, so each device knows which beacons got through on which channel.
+*/
+void loopHopping() {
+  unsigned long now = millis();
+
+  channelSwitchPoll(now);
+  if (now - hopSlotStart >= hopSlotLength) {
+    unsigned long slots = (now - hopSlotStart) / hopSlotLength;   // More than one if loop() was held up
+    bool expected = !hopDeferred && hopSynced && hopPeerHeard && hopSlot - hopLastHeard <= hopSyncTimeout;
+
+    if (hopRecord(hopSchedule, hopIndex, expected, hopBeaconReceived)) {
+      Serial.print(F("Hopping: channel "));
+      Serial.print(hopSchedule.channels[hopIndex]);
+      Serial.println(F(" marked bad."));
+    }
+    hopSlot += slots;
+    hopSlotStart += slots * hopSlotLength;
+    hopBeaconReceived = false;
+    hopBeaconSent = false;
+
+    if (!isInitiator && hopSynced && hopSlot - hopLastHeard > hopSyncTimeout) {
+      hopSynced = false;                                  // Lost the initiator, park and listen for its beacons
+      Serial.println(F("Hopping: lost sync."));
+    }
+    if ((int32_t)(hopSlot - hopNextSkipSlot) >= 0) {
+      hopSetSkipMask(hopSchedule, hopNextSkip);
+    }
+    if (isInitiator) {
+      uint16_t proposal = hopProposeSkipMask(hopSchedule, hopPeerBad);
+      if (proposal != hopNextSkip) {                      // Announce it in the next beacons before using it
+        hopNextSkip = proposal;
+        hopNextSkipSlot = hopSlot + hopMaskDelay;
+      }
+    }
+
+    hopDeferred = shellAtPending || linkSwitchBusy() || channelSwitchBusy();
+    if (!hopDeferred) {
+      uint8_t channel = hopTuneChannel();
+      if (channel != channelSwitchChannel()) {
+        channelSwitchStart(channel, now);
+      }
+    }
+  }
+
+  if (!radioClear()) {
+    return;
+  }
+  if (isInitiator ? !hopBeaconSent && now - hopSlotStart >= hopBeaconOffset : hopReplyDue) {
+    sendHopBeacon();
+    hopBeaconSent = true;
+    hopReplyDue = false;
+  }
+}
+#endif
+
+/*
+*@brief Function to advertise the free space of the playback queue to the other device
+*/
+void advertiseCredit() {
+  uint16_t free = playbackFree();
+  uint16_t credit = free > creditMargin ? free - creditMargin : 0;
+  uint8_t payload[3] = {(uint8_t)credit, (uint8_t)(credit >> 8), messagesReceived};
+
+  sendFrame(FRAME_CREDIT, payload, sizeof(payload));
+  creditAdvertised = free;
+  creditRequested = false;
+  lastCreditSent = millis();
+}
+
+/*
+*@brief Function to send queued paced messages while the other device has credit for them
+*@details Until the other device advertised any credit, messages are sent without pacing.
+*/
+void loopTransmit() {
+  if (!radioClear()) {
+    return;
+  }
+  while (txQueueCount > 0) {
+    TxMessage& message = txQueue[txQueueHead];
+
+    if (remoteCredit >= 0 && (long)message.cost > remoteCredit) {
+      if (millis() - lastCreditReceived > creditRequestTimeout) {
+        sendFrame(FRAME_CREDIT, 0, 0);                    // Credit may have been lost, ask again
+        lastCreditReceived = millis();
+      }
+      return;
+    }
+
+    radioWrite(message.data, message.length);
+    if (remoteCredit >= 0) {
+      remoteCredit -= message.cost;
+    }
+    uint8_t index = messagesSent % sentHistorySize;
+    sentCost[index] = message.cost;
+    sentTime[index] = millis();
+    messagesSent++;
+
+    txQueueHead = (txQueueHead + 1) % txQueueSize;
+    txQueueCount--;
+  }
+}
+
+/*
+*@brief Function to advertise credit when it changed or was asked for, call once per loop
+*/
+void loopCredit() {
+  if (!radioClear()) {
+    return;
+  }
+  if ((creditRequested || playbackFree() != creditAdvertised) && millis() - lastCreditSent >= creditInterval) {
+    advertiseCredit();
+  }
+}
+
+/*
+*@brief Function to send a paced message, it waits in the send queue until the other device has room to play it
+*@param _cost Number of playback items the message adds on the other device
+*/
+void queueRadio(const uint8_t* _data, byte _length, uint16_t _cost) {
+  if (txQueueCount >= txQueueSize) {
+    Serial.println(F("Send queue full, message dropped."));
+    txDropped++;
+    return;
+  }
+
+  TxMessage& message = txQueue[(txQueueHead + txQueueCount) % txQueueSize];
+  memcpy(message.data, _data, _length);
+  message.length = _length;
+  message.cost = _cost;
+  txQueueCount++;
+  PROBE_QUEUED();                                     // Before loopTransmit(), which may write it right away
+
+  loopTransmit();
+  if (txQueueCount > 0) {
+    txDelayed++;
+  }
+}
+
+/*
+*@brief Function to send a paced frame via HC-12, see queueRadio()
+*/
+void queueFrame(uint8_t _type, const uint8_t* _payload, byte _length, uint16_t _cost) {
+  uint8_t buffer[FRAME_MAX_SIZE];
+  byte size = frameEncode(_type, _payload, _length, buffer);
+
+  queueRadio(buffer, size, _cost);
+  framesSent++;
+}
+
+/*
+*@brief Function to send the word keyed in character mode
+*@details The word is compressed with the shared word table, so common words cost a single byte on air.
+*/
+void sendKeyedWord() {
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+  byte length = textCompress(keyedWord, keyedWordLength, payload, sizeof(payload));
+
+  Serial.print(F("Sending Word: "));
+  for (byte i = 0; i < keyedWordLength; i++) {
+    printSymbol(keyedWord[i]);
+  }
+  Serial.println();
+
+  if (length > 0) {
+    queueFrame(FRAME_TEXT, payload, length, textPlaybackCost(keyedWord, keyedWordLength));
+    textSymbolsSent += keyedWordLength;
+    textBytesSent += length;
+  } else {
+    Serial.println(F("Word too long to send."));
+  }
+  keyedWordLength = 0;
+}
+
+/*
+*@brief Function to collect a keyed element into the current character in character mode
+*@param _value 1 for dot, 2 for dash
+*@note With useBeamDecoder the press and pause durations are decoded instead of the dot/dash value.
+*/
+void keyCharacterElement(int _value) {
+  if (useBeamDecoder) {
+    unsigned long gap = lastButtonPressTime - lastKeyReleaseTime;
+    beamDecoderMark(min(lastPressDuration, 0xFFFFUL), min(gap, 0xFFFFUL));
+  } else {
+    keyedCode = morseAppendElement(keyedCode, _value == 2);
+  }
+  lastKeyReleaseTime = lastButtonPressTime + lastPressDuration;
+}
+
+/*
+*@brief Function to add a decoded symbol to the word being keyed in character mode
+*/
+void addKeyedSymbol(uint8_t _symbol) {
+  if (keyedWordLength < FRAME_MAX_PAYLOAD) {
+    keyedWord[keyedWordLength++] = _symbol;
+    Serial.print(F("Character: "));
+    printSymbol(_symbol);
+    Serial.println();
+  }
+}
+
+/*
+*@brief Function to complete characters and words in character mode once the keying pauses
+*/
+void loopCharacterMode() {
+  unsigned long idle = millis() - lastKeyReleaseTime;
+
+  if ((keyedCode != MORSE_EMPTY_CODE || beamDecoderBusy()) && idle > morseCharacterThreshold(keyingTiming)) {
+    uint8_t symbols[2];
+    byte count;
+
+    if (useBeamDecoder) {
+      count = beamDecoderFinish(symbols);
+    } else {
+      symbols[0] = morseDecode(keyedCode);
+      count = symbols[0] != 0 ? 1 : 0;
+      keyedCode = MORSE_EMPTY_CODE;
+    }
+
+    if (count == 0) {
+      Serial.println(F("Unknown character."));
+      beepAndBuzz(1, 1000);                               // Long beep, the character is dropped
+    }
+    for (byte i = 0; i < count; i++) {
+      addKeyedSymbol(symbols[i]);
+    }
+  }
+
+  if (keyedWordLength > 0 && idle > morseWordThreshold(keyingTiming)) {
+    sendKeyedWord();
+  }
+}
+
+/*
+*@brief Function to send the elements collected in element stream mode as one frame
+*/
+void sendKeyedStream() {
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+  byte length = elementStreamEncode(keyedStream, payload, sizeof(payload));
+
+  Serial.print(F("Sending Elements: "));
+  Serial.println(keyedStream.count);
+
+  queueFrame(FRAME_ELEMENTS, payload, length, keyedStream.count);
+  elementStreamInit(keyedStream, keyedStreamBits, sizeof(keyedStreamBits));
+  keyedStreamAfterCharacter = true;
+}
+
+/*
+*@brief Function to collect a keyed element in element stream mode
+*@param _value 1 for dot, 2 for dash
+*/
+void keyStreamElement(int _value) {
+  if (keyedStream.count == 0 && keyedStreamStartsWord) {
+    elementStreamAppend(keyedStream, ELEMENT_WORD_GAP);
+    keyedStreamStartsWord = false;
+  }
+
+  if (!elementStreamAppend(keyedStream, _value == 2 ? ELEMENT_DASH : ELEMENT_DOT)) {
+    sendKeyedStream();                                    // Buffer full, send what is there and start over
+    elementStreamAppend(keyedStream, _value == 2 ? ELEMENT_DASH : ELEMENT_DOT);
+  }
+  elementsSent++;
+  lastKeyReleaseTime = lastButtonPressTime + lastPressDuration;
+}
+
+/*
+*@brief Function to send the keyed elements once the keying pauses in element stream mode
+*@details The frame is sent at the character gap. A word gap is sent at the start of the next frame.
+*/
+void loopElementStream() {
+  unsigned long idle = millis() - lastKeyReleaseTime;
+
+  if (keyedStream.count > 0 && idle > morseCharacterThreshold(keyingTiming)) {
+    if (!elementStreamAppend(keyedStream, ELEMENT_CHARACTER_GAP)) {
+      sendKeyedStream();
+      elementStreamAppend(keyedStream, ELEMENT_CHARACTER_GAP);
+    }
+    sendKeyedStream();
+  }
+
+  if (keyedStreamAfterCharacter && idle > morseWordThreshold(keyingTiming)) {
+    keyedStreamAfterCharacter = false;
+    keyedStreamStartsWord = true;
+  }
+}
+
+/*
+*@brief Function to classify a press duration as dot or dash
+*@return 1 for dot, 2 for dash, 0 if the press is too short to count
+*/
+int classifyPress(unsigned long _pressDuration) {
+  return morseClassifyPress(keyingTiming, _pressDuration);
+}
+
+/*
+*@brief Function to time presses of the Morse key without waiting for the release, call once per loop
+*@details Beeps once the press is long enough for a dash and again at the command mode gesture threshold. After a
+*         release the key is ignored for keyDebounce.
+*@return 1 for dot or 2 for dash when a press ended, 0 otherwise
+*/
+int talkMorse() {
+  unsigned long now = millis();
+
+  if (!keyPressed) {
+    if (now - keyReleaseTime < keyDebounce || !keyDown()) {
+      return 0;
+    }
+    PROBE_KEY_EDGE();
+    keyPressed = true;
+    dashBeeped = false;
+    gestureBeeped = false;
+    lastButtonPressTime = now;
+    return 0;
+  }
+
+  unsigned long holdDuration = now - lastButtonPressTime;
+  if (keyDown()) {
+    // 🔊 Beep once when dash threshold is reached
+    if (!dashBeeped && holdDuration > morseDashThreshold(keyingTiming)) {
+      beepAndBuzz(1, 100);                                // Short beep
+      dashBeeped = true;
+    }
+
+    // 🔊 Beep again when the command mode gesture threshold is reached
+    if (!gestureBeeped && holdDuration > GESTURE_HOLD_DURATION) {
+      beepAndBuzz(2, 50);
+      gestureBeeped = true;
+    }
+    return 0;
+  }
+
+  PROBE_KEY_EDGE();
+  keyPressed = false;
+  keyReleaseTime = now;
+  lastPressDuration = holdDuration;
+  return classifyPress(holdDuration);
+}
+
+/*
+*@brief Function to act on a keyed element from the button or the tone input
+*@details The press is offered to the gesture recognizer first, then sent according to sendMode.
+*@param _value 1 for dot, 2 for dash
+*@note lastButtonPressTime and lastPressDuration must describe the press.
+*/
+void keyElement(int _value) {
+  if (gestureOnPress(lastPressDuration, _value == 2, lastButtonPressTime + lastPressDuration)) {
+    return;                                                             // The press belongs to a command
+  }
+
+  if (loopbackTestMode && !loopbackKeyPending) {
+    loopbackKeyTime = micros();                                         // Time this element until it is played back
+    loopbackKeyPending = true;
+  }
+
+  if (sendMode == SEND_CHARACTERS) {
+    keyCharacterElement(_value);                                        // Collect the element into the current character
+  } else if (sendMode == SEND_ELEMENT_STREAM) {
+    keyStreamElement(_value);                                           // Collect the element into the next element stream
+  } else {
+    Serial.print(F("Sending: "));
+    Serial.println(_value);
+    uint8_t line[] = {(uint8_t)('0' + _value), '\r', '\n'};             // Same bytes as println(_value)
+    queueRadio(line, sizeof(line), 1);                                  // Send the morse value via HC-12 once there is credit
+    elementsSent++;
+  }
+}
+
+#if TONE_INPUT
+/*
+*@brief Function to key elements from the tone detected on TONE_INPUT_PIN
+*@details Each completed tone is classified like a button press and keyed the same way.
+*/
+void loopToneInput() {
+  unsigned long start;
+  unsigned long duration;
+
+  while (toneInputPoll(&start, &duration)) {
+    lastButtonPressTime = start;
+    lastPressDuration = duration;
+
+    int value = classifyPress(duration);
+    if (value > 0) {
+      keyElement(value);
+    }
+  }
+}
+#endif
+
+/*
+*@brief Function to derive the playback durations from playbackWpm
+*@details Standard 1:3:7 timing, see morse_timing.h. The playback queue adds its character and word gaps on top of
+*         the gap after the last element, so they are set to the difference.
+*/
+void applyPlaybackWpm() {
+  morseTimingCompute(playbackTiming, playbackWpm, playbackFarnsworthWpm);
+
+  PlaybackTiming timing;
+  timing.dot = playbackTiming.dot;
+  timing.dash = playbackTiming.dash;
+  timing.elementGap = playbackTiming.dot;
+  timing.characterGap = playbackTiming.characterGap - playbackTiming.dot;   // Follows an element gap
+  timing.wordGap = playbackTiming.wordGap - playbackTiming.characterGap;    // Follows a character gap
+  playbackSetTiming(timing);
+}
+
+/*
+*@brief Function to print one line of the link statistics, lines of features that are off print nothing
+*@param _line Line number, from 0
+*@return False once all lines were printed
+*/
+bool printStatsLine(byte _line) {
+  if (_line >= statsHopLine && _line < statsHopLine + HOP_MAX_CHANNELS) {
+#if FREQUENCY_HOPPING
+    byte i = _line - statsHopLine;
+    if (i < hopSchedule.count) {
+      Serial.print(F("Hop Channel "));
+      Serial.print(hopSchedule.channels[i]);
+      Serial.print(F(" Beacons Lost/Expected: "));
+      Serial.print(hopSchedule.totalLost[i]);
+      Serial.print(F("/"));
+      Serial.println(hopSchedule.totalExpected[i]);
+    }
+#endif
+    return true;
+  }
+
+  switch (_line) {
+    case 0:
+      Serial.println(F("-----------------------------------"));
+      return true;
+    case 1:
+      Serial.print(F("Elements Sent: "));
+      Serial.println(elementsSent);
+      return true;
+    case 2:
+      Serial.print(F("Elements Received: "));
+      Serial.println(elementsReceived);
+      return true;
+    case 3:
+      Serial.print(F("Invalid Received: "));
+      Serial.println(invalidReceived);
+      return true;
+    case 4:
+      Serial.print(F("Frames Sent: "));
+      Serial.println(framesSent);
+      return true;
+    case 5:
+      Serial.print(F("Frames Received: "));
+      Serial.println(framesReceived);
+      return true;
+    case 6:
+      Serial.print(F("Frames Dropped: "));
+      Serial.println(framesDropped);
+      return true;
+    case 7:
+      Serial.print(F("Text Characters/Bytes Sent: "));
+      Serial.print(textSymbolsSent);
+      Serial.print(F("/"));
+      Serial.println(textBytesSent);
+      return true;
+    case 8:
+      Serial.print(F("Playback WPM: "));
+      Serial.println(playbackWpm);
+      return true;
+    case 9:
+      Serial.print(F("Playback Queued/Dropped: "));
+      Serial.print(playbackQueued());
+      Serial.print(F("/"));
+      Serial.println(playbackDropped);
+      return true;
+    case 10:
+      Serial.print(F("Playback Speed (%): "));
+      Serial.println(playbackSpeedPercent());
+      return true;
+    case 11:
+      Serial.print(F("Remote Credit: "));
+      Serial.println(remoteCredit);
+      return true;
+    case 12:
+      Serial.print(F("Messages Delayed/Dropped: "));
+      Serial.print(txDelayed);
+      Serial.print(F("/"));
+      Serial.println(txDropped);
+      return true;
+    case 13:
+      Serial.print(F("Link Profile: "));
+      Serial.println(linkProfiles[linkProfileIndex].fuCommand);
+      return true;
+    case 14:
+      Serial.print(F("Send Mode: "));
+      Serial.println(sendMode);
+      return true;
+    case 15:
+      Serial.print(F("Keying Dot Estimate: "));
+      Serial.println(beamDecoderDotEstimate());
+      return true;
+    case 16:
+#if TONE_INPUT
+      Serial.print(F("Tone Power/Threshold: "));
+      Serial.print(toneInputPower());
+      Serial.print(F("/"));
+      Serial.println(toneInputThreshold());
+#endif
+      return true;
+    case 17:
+#if TONE_INPUT
+      Serial.print(F("Tone Sample Overruns: "));
+      Serial.println(adcSamplerOverruns());
+#endif
+      return true;
+    case 18:
+      if (loopbackTestMode && loopbackLatencyCount > 0) {
+        Serial.print(F("Loopback Latency Min/Avg/Max (us): "));
+        Serial.print(loopbackLatencyMin);
+        Serial.print(F("/"));
+        Serial.print(loopbackLatencyTotal / loopbackLatencyCount);
+        Serial.print(F("/"));
+        Serial.println(loopbackLatencyMax);
+      }
+      return true;
+    case 19:
+#if LOOPBACK_TEST
+      if (loopbackLatencyCount > 0) {
+        Serial.print(F("Loopback Overflows: "));
+        Serial.println(loopback.overflows());
+      }
+#endif
+      return true;
+    case 20:
+#if SECURE_FRAMES
+      Serial.print(F("Secure Counter/Rejected/Replays: "));
+      Serial.print(secureCounter);
+      Serial.print(F("/"));
+      Serial.print(secureRejected);
+      Serial.print(F("/"));
+      Serial.println(replayRejected);
+#endif
+      return true;
+    case 21:
+      if (channelScanMode || FREQUENCY_HOPPING) {
+        Serial.print(F("Channel/Hops/Failures: "));
+        Serial.print(channelSwitchChannel());
+        Serial.print(F("/"));
+        Serial.print(channelSwitchCount());
+        Serial.print(F("/"));
+        Serial.println(channelSwitchFailures());
+      }
+      return true;
+    case 22:
+      if (channelScanMode || FREQUENCY_HOPPING) {
+        Serial.print(F("Hop Time (ms): "));
+        Serial.println(channelSwitchTime());
+      }
+      return true;
+    case 23:
+#if FREQUENCY_HOPPING
+      Serial.print(F("Hop Slot/Synced/Skipped: "));
+      Serial.print(hopSlot);
+      Serial.print(F("/"));
+      Serial.print(hopSynced ? F("yes") : F("no"));
+      Serial.print(F("/"));
+      Serial.println(hopSchedule.skipMask, BIN);
+#endif
+      return true;
+    case statsHopLine + HOP_MAX_CHANNELS:
+      if (faultInjectionEnabled) {
+        Serial.print(F("Faults Dropped/Flipped/Duplicated: "));
+        Serial.print(radioFaults.stats.dropped);
+        Serial.print(F("/"));
+        Serial.print(radioFaults.stats.flipped);
+        Serial.print(F("/"));
+        Serial.println(radioFaults.stats.duplicated);
+      }
+      return true;
+    case statsHopLine + HOP_MAX_CHANNELS + 1:
+      if (faultInjectionEnabled) {
+        Serial.print(F("Faults Reordered/Truncated/Faded: "));
+        Serial.print(radioFaults.stats.reordered);
+        Serial.print(F("/"));
+        Serial.print(radioFaults.stats.truncated);
+        Serial.print(F("/"));
+        Serial.println(radioFaults.stats.fadeDropped);
+      }
+      return true;
+    default:
+      Serial.println(F("-----------------------------------"));
+      return false;
+  }
+}
+
+/*
+*@brief Function to print the next lines of the statistics while the serial port has room for them, so printing
+*       never waits
+*/
+void loopStatsDump() {
+  while (statsDumpActive && Serial.availableForWrite() >= statsLineRoom) {
+    statsDumpActive = printStatsLine(statsDumpNext++);
+  }
+}
+
+/*
+*@brief Function to start printing the link statistics to the serial monitor, loopStatsDump() prints them
+*/
+void dumpStats() {
+  statsDumpActive = true;
+  statsDumpNext = 0;
+}
+
+/*
+*@brief Function to switch profiles and send reports requested by a throughput benchmark on the other device
+*/
+void loopBenchmark() {
+  if (benchmarkProfileRequest != benchmarkNoProfile && !channelSwitchBusy() && !linkSwitchBusy() && !shellAtPending) {
+    startLinkProfile(benchmarkProfileRequest);            // The other device waits long enough for it
+    benchmarkProfileRequest = benchmarkNoProfile;
+  }
+
+  if (benchmarkReportRequested && radioClear()) {        // Not while the switch just started runs
+    unsigned long elapsed = benchmarkReceived > 0 ? benchmarkLastTime - benchmarkFirstTime : 0;
+    uint8_t report[7] = {BENCHMARK_REPORT, (uint8_t)benchmarkReceived, (uint8_t)(benchmarkReceived >> 8)};
+    for (byte i = 0; i < 4; i++) {
+      report[3 + i] = elapsed >> (8 * i);
+    }
+    sendFrame(FRAME_BENCHMARK, report, sizeof(report));
+    benchmarkReportRequested = false;
+  }
+}
+
+/*
+*@brief Function to send a FRAME_BENCHMARK frame with a one byte argument
+*/
+void sendBenchmarkFrame(uint8_t _operation, uint8_t _argument) {
+  uint8_t payload[2] = {_operation, _argument};
+  sendFrame(FRAME_BENCHMARK, payload, sizeof(payload));
+}
+
+/*
+*@brief Function to check if a throughput benchmark runs on this device
+*/
+bool benchmarkBusy() {
+  return benchmarkStep != BENCH_IDLE;
+}
+
+/*
+*@brief Function to move the throughput benchmark to its next step
+*/
+void enterBenchmarkStep(byte _step) {
+  benchmarkStep = _step;
+  benchmarkStepTime = millis();
+}
+
+/*
+*@brief Function to start measuring how many elements per second the link sustains at every link profile,
+*       loopThroughputBenchmark() runs it
+*@details The other device is switched to each profile in turn, then benchmarkElementCount element lines are
+*         streamed to it as fast as the radio takes them. It counts them with the sounder muted and reports how many
+*         arrived and over what time. Afterwards both devices return to the profile in use before.
+*@note Keeps receiving while sending, so it also runs against itself in loopback test mode.
+*/
+void startThroughputBenchmark() {
+  benchmarkOriginalProfile = linkProfileIndex;
+  benchmarkProfile = 0;
+  Serial.println(F("-----------------------------------"));
+  Serial.println(F("Profile  Sent/s  Received/s  Bytes/s  Loss%"));
+  enterBenchmarkStep(BENCH_REQUEST);
+}
+
+/*
+*@brief Function to print the benchmark results of the profile just measured
+*@param _lineSize Size of one element line in bytes
+*/
+void printBenchmarkResult(byte _lineSize) {
+  Serial.print(linkProfiles[benchmarkProfile].fuCommand);
+  Serial.print(F("   "));
+  Serial.print(benchmarkElementCount * 1000UL / benchmarkSendTime);
+  if (!benchmarkReportReady) {
+    Serial.println(F("    no report"));
+    return;
+  }
+  unsigned long elapsed = max(benchmarkReportElapsed, 1UL);
+  unsigned long received = benchmarkReportCount;
+  Serial.print(F("    "));
+  Serial.print(received > 1 ? (received - 1) * 1000UL / elapsed : 0);
+  Serial.print(F("          "));
+  Serial.print(received > 1 ? (received - 1) * _lineSize * 1000UL / elapsed : 0);
+  Serial.print(F("      "));
+  Serial.println((benchmarkElementCount - min(received, (unsigned long)benchmarkElementCount)) * 100UL / benchmarkElementCount);
+}
+
+/*
+*@brief Function to advance a throughput benchmark started by startThroughputBenchmark(), call once per loop
+*@details Every step waits for its time or for radioClear() by returning, so nothing else is held up. One element
+*         line is streamed per pass.
+*/
+void loopThroughputBenchmark() {
+  const byte lineSize = 3;                                // "1\r\n"
+  unsigned long now = millis();
+  byte profile = benchmarkProfile < linkProfileCount ? benchmarkProfile : benchmarkOriginalProfile;
+
+  switch (benchmarkStep) {
+    case BENCH_REQUEST:
+      if (radioClear()) {
+        sendBenchmarkFrame(BENCHMARK_PROFILE, profile);
+        enterBenchmarkStep(BENCH_SWITCH);
+      }
+      return;
+
+    case BENCH_SWITCH:
+      if (now - benchmarkStepTime >= benchmarkFrameTime && !channelSwitchBusy() && !linkSwitchBusy() &&
+          !shellAtPending) {                              // Let the frame leave before reconfiguring this module
+        startLinkProfile(profile);
+        enterBenchmarkStep(BENCH_SETTLE);
+      }
+      return;
+
+    case BENCH_SETTLE:
+      if (linkSwitchBusy()) {
+        benchmarkStepTime = now;                          // Settling counts from the end of this device's switch
+        return;
+      }
+      if (now - benchmarkStepTime < benchmarkSettleTime) {
+        return;                                           // The other device switches meanwhile
+      }
+      if (benchmarkProfile == linkProfileCount) {
+        Serial.println(F("-----------------------------------"));
+        benchmarkStep = BENCH_IDLE;
+        return;
+      }
+      if (radioClear()) {
+        benchmarkReportReady = false;
+        sendBenchmarkFrame(BENCHMARK_START, 0);
+        benchmarkSent = 0;
+        enterBenchmarkStep(BENCH_STREAM);
+      }
+      return;
+
+    case BENCH_STREAM:
+      if (!radioClear()) {
+        return;
+      }
+      if (benchmarkSent < benchmarkElementCount) {
+        uint8_t line[lineSize] = {(uint8_t)(benchmarkSent & 1 ? '2' : '1'), '\r', '\n'};
+        radioWrite(line, lineSize);
+        benchmarkSent++;
+        return;
+      }
+      benchmarkSendTime = max(now - benchmarkStepTime, 1UL);
+      sendBenchmarkFrame(BENCHMARK_END, 0);
+      enterBenchmarkStep(BENCH_REPORT);
+      return;
+
+    case BENCH_REPORT:
+      if (benchmarkReportReady || now - benchmarkStepTime >= benchmarkReportTimeout) {
+        printBenchmarkResult(lineSize);
+        benchmarkProfile++;                               // The last pass restores the original profile
+        enterBenchmarkStep(BENCH_REQUEST);
+      }
+      return;
+
+    default:
+      return;
+  }
+}
+
+/*
+*@brief Function to execute a command letter keyed in command mode
+*@param _command Packed Morse code of the command letter or one of the GESTURE_* events
+*/
+void runGestureCommand(byte _command) {
+  switch (_command) {
+    case GESTURE_ENTER:
+      Serial.println(F("Command mode entered."));
+      return;
+    case GESTURE_EXIT:
+      Serial.println(F("Command mode left."));
+      beepAndBuzz(2, 50);
+      return;
+    case GESTURE_CMD_STATS:
+      dumpStats();
+      break;
+    case GESTURE_CMD_WPM_UP:
+      if (playbackWpm < maxPlaybackWpm) {
+        playbackWpm++;
+      }
+      applyPlaybackWpm();
+      Serial.print(F("Playback WPM: "));
+      Serial.println(playbackWpm);
+      break;
+    case GESTURE_CMD_WPM_DOWN:
+      if (playbackWpm > minPlaybackWpm) {
+        playbackWpm--;
+      }
+      applyPlaybackWpm();
+      Serial.print(F("Playback WPM: "));
+      Serial.println(playbackWpm);
+      break;
+    case GESTURE_CMD_LINK:
+      if (channelSwitchBusy() || linkSwitchBusy()) {
+        Serial.println(F("Busy, try again."));
+        beepAndBuzz(1, 1000);
+        return;
+      }
+      startLinkProfile((linkProfileIndex + 1) % linkProfileCount); // loopLinkSwitch() finishes it
+      break;
+    case GESTURE_CMD_BENCHMARK:
+      if (benchmarkBusy()) {
+        Serial.println(F("Busy, try again."));
+        beepAndBuzz(1, 1000);
+        return;
+      }
+      startThroughputBenchmark();                         // loopThroughputBenchmark() runs it
+      break;
+    case GESTURE_CMD_SEND_MODE:
+      sendMode = (sendMode + 1) % sendModeCount;
+      keyedCode = MORSE_EMPTY_CODE;                       // Drop anything collected for the previous mode
+      keyedWordLength = 0;
+      elementStreamInit(keyedStream, keyedStreamBits, sizeof(keyedStreamBits));
+      Serial.print(F("Send Mode: "));
+      Serial.println(sendMode);
+      break;
+    default:
+      Serial.println(F("Unknown command."));
+      beepAndBuzz(1, 1000);                               // Long beep for an unknown command
+      return;
+  }
+
+  beepAndBuzz(1, 50);                                     // Short beep to acknowledge the command
+}
+
+/*
+*@brief Function to poll the gesture recognizer and run completed commands
+*/
+void loopGestures() {
+  byte command = gesturePoll(millis());
+
+  if (command != GESTURE_NONE) {
+    runGestureCommand(command);
+  }
+}
+
+/*
+*@brief Function to send a binary reply to the serial monitor, in the frame format with the request's opcode as type
+*/
+void shellReply(uint8_t _opcode, const uint8_t* _payload, byte _length) {
+  uint8_t buffer[FRAME_MAX_SIZE];
+  byte size = frameEncode(_opcode, _payload, _length, buffer);
+
+  Serial.write(buffer, size);
+}
+
+/*
+*@brief Function to answer a serial command with just a status, SHELL_STATUS_*
+*/
+void shellStatus(const ShellCommand& _command, uint8_t _status) {
+  if (_command.binary) {
+    shellReply(_command.opcode, &_status, 1);
+    return;
+  }
+  switch (_status) {
+    case SHELL_STATUS_OK:
+      Serial.println(F("OK"));
+      break;
+    case SHELL_STATUS_BAD_ARGUMENT:
+      Serial.println(F("Bad argument."));
+      break;
+    case SHELL_STATUS_BUSY:
+      Serial.println(F("Busy, try again."));
+      break;
+    default:
+      Serial.println(F("Unknown command, try help."));
+      break;
+  }
+}
+
+/*
+*@brief Function to read the number argument of a serial command, one byte in binary mode or decimal text
+*/
+bool shellArgument(const ShellCommand& _command, uint16_t* _value) {
+  if (_command.binary) {
+    if (_command.argumentLength != 1) {
+      return false;
+    }
+    *_value = _command.argument[0];
+    return true;
+  }
+  return shellNumber(_command.argument, _command.argumentLength, _value);
+}
+
+/*
+*@brief Function to store a 32 bit value little endian, for binary replies
+*/
+void storeLong(uint8_t* _out, unsigned long _value) {
+  for (byte i = 0; i < 4; i++) {
+    _out[i] = (uint8_t)(_value >> (8 * i));
+  }
+}
+
+/*
+*@brief Function to send the main statistics as one binary reply
+*@details After the status: elements sent and received, frames sent, received and dropped and invalid messages, each
+*         32 bit, then playback queue length (16 bit), playback WPM, link profile and send mode.
+*/
+void shellStatsReply() {
+  uint8_t payload[30];
+  uint16_t queued = playbackQueued();
+
+  payload[0] = SHELL_STATUS_OK;
+  storeLong(payload + 1, elementsSent);
+  storeLong(payload + 5, elementsReceived);
+  storeLong(payload + 9, framesSent);
+  storeLong(payload + 13, framesReceived);
+  storeLong(payload + 17, framesDropped);
+  storeLong(payload + 21, invalidReceived);
+  payload[25] = (uint8_t)queued;
+  payload[26] = (uint8_t)(queued >> 8);
+  payload[27] = (uint8_t)playbackWpm;
+  payload[28] = linkProfileIndex;
+  payload[29] = sendMode;
+  shellReply(SHELL_OP_STATS, payload, sizeof(payload));
+}
+
+/*
+*@brief Function to run a command from the serial monitor
+*@details Commands that take a while, the AT command, the link profile switch and the trace and statistics dumps, are
+*         only started here and finished in loop() so the radio keeps being served.
+*/
+void runShellCommand(const ShellCommand& _command) {
+  uint16_t value;
+
+  switch (_command.opcode) {
+    case SHELL_OP_HELP:
+      if (_command.binary) {
+        shellStatus(_command, SHELL_STATUS_OK);
+        return;
+      }
+#if RADIO_TRACE
+      Serial.println(F("stats | wpm <n> | link <n> | at <command> | bridge | trace | key <durations>"));
+#else
+      Serial.println(F("stats | wpm <n> | link <n> | at <command> | bridge | key <durations>"));
+#endif
+      return;
+
+    case SHELL_OP_STATS:
+      if (_command.binary) {
+        shellStatsReply();
+      } else {
+        dumpStats();
+      }
+      return;
+
+    case SHELL_OP_WPM:
+      if (!shellArgument(_command, &value) || value < minPlaybackWpm || value > maxPlaybackWpm) {
+        shellStatus(_command, SHELL_STATUS_BAD_ARGUMENT);
+        return;
+      }
+      playbackWpm = value;
+      applyPlaybackWpm();
+      shellStatus(_command, SHELL_STATUS_OK);
+      return;
+
+    case SHELL_OP_LINK:
+      if (!shellArgument(_command, &value) || value >= linkProfileCount) {
+        shellStatus(_command, SHELL_STATUS_BAD_ARGUMENT);
+        return;
+      }
+      if (channelSwitchBusy() || shellAtPending || linkSwitchBusy()) {
+        shellStatus(_command, SHELL_STATUS_BUSY);
+        return;
+      }
+      startLinkProfile(value);
+      shellLinkPending = true;                            // loopShell() replies once the switch is done
+      shellLinkBinary = _command.binary;
+      return;
+
+    case SHELL_OP_AT:
+      if (channelSwitchBusy() || shellAtPending || linkSwitchBusy()) {
+        shellStatus(_command, SHELL_STATUS_BUSY);
+        return;
+      }
+      if (!channelSwitchCommand((const char*)_command.argument, _command.argumentLength, millis())) {
+        shellStatus(_command, SHELL_STATUS_BAD_ARGUMENT);
+        return;
+      }
+      shellAtPending = true;                              // loopShell() replies once the module answered
+      shellAtBinary = _command.binary;
+      return;
+
+    case SHELL_OP_BRIDGE:
+      if (channelSwitchBusy() || shellAtPending || linkSwitchBusy()) {
+        shellStatus(_command, SHELL_STATUS_BUSY);
+        return;
+      }
+      if (_command.binary) {
+        shellStatus(_command, SHELL_STATUS_OK);
+      } else {
+        Serial.print(F("HC-12 in AT mode, back to normal after "));
+        Serial.print(bridgeIdleTimeout / 1000);
+        Serial.println(F(" s without input."));
+      }
+      bridgeBinary = _command.binary;
+      channelSwitchBridge(Serial, bridgeIdleTimeout, millis()); // loop() serves only the bridge until it ends
+      return;
+
+#if RADIO_TRACE
+    case SHELL_OP_TRACE:
+      traceDumpActive = true;                             // loopShell() prints it as the serial port has room
+      traceDumpBinary = _command.binary;
+      traceDumpNext = 0;
+      return;
+#endif
+
+    case SHELL_OP_KEY:
+      if (!scriptedKeying) {
+        shellStatus(_command, SHELL_STATUS_BAD_ARGUMENT);
+        return;
+      }
+      for (byte i = 0; i < _command.argumentLength; i++) {
+        keyScriptFeed(_command.argument[i]);
+      }
+      shellStatus(_command, keyScriptFeed('\n') ? SHELL_STATUS_OK : SHELL_STATUS_BAD_ARGUMENT);
+      return;
+
+    default:
+      shellStatus(_command, SHELL_STATUS_UNKNOWN);
+      return;
+  }
+}
+
+#if RADIO_TRACE
+/*
+*@brief Function to print the next part of the trace if the serial port has room for it, so printing never waits
+*@details In binary mode each reply holds up to 5 entries of time (32 bit), event and detail after the status, and an
+*         empty reply ends the dump.
+*/
+void loopTraceDump() {
+  if (traceDumpBinary) {
+    if (Serial.availableForWrite() < FRAME_OVERHEAD + 31) {
+      return;
+    }
+    uint8_t payload[31];
+    byte length = 1;
+    payload[0] = SHELL_STATUS_OK;
+    while (traceDumpNext < traceCount() && length <= sizeof(payload) - 6) {
+      const TraceEntry& entry = traceEntry(traceDumpNext++);
+      storeLong(payload + length, entry.time);
+      payload[length + 4] = entry.event;
+      payload[length + 5] = entry.detail;
+      length += 6;
+    }
+    shellReply(SHELL_OP_TRACE, payload, length);
+    traceDumpActive = length > 1;
+    return;
+  }
+
+  if (Serial.availableForWrite() < 24) {
+    return;
+  }
+  if (traceDumpNext >= traceCount()) {
+    Serial.println(F("End of trace."));
+    traceDumpActive = false;
+    return;
+  }
+  const TraceEntry& entry = traceEntry(traceDumpNext++);
+  Serial.print(entry.time);
+  Serial.print(F(" "));
+  Serial.print((char)entry.event);
+  Serial.print(F(" "));
+  if (entry.event == TRACE_CHANNEL) {
+    Serial.println(entry.detail);
+  } else {
+    Serial.println((char)entry.detail);
+  }
+}
+#endif
+
+/*
+*@brief Function to read commands from the serial monitor and finish those still running, call once per loop
+*/
+void loopShell() {
+  while (Serial.available() && !channelSwitchBridging()) { // Once bridging, the rest of the input is for the HC-12
+    uint8_t event = shellFeed(shell, Serial.read());
+    if (event == SHELL_COMMAND) {
+      runShellCommand(shell.command);
+    } else if (event == SHELL_ERROR) {
+      Serial.println(F("Unknown command, try help."));
+    }
+  }
+
+  if (shellAtPending) {
+    channelSwitchPoll(millis());
+    if (!channelSwitchBusy()) {
+      const char* reply = channelSwitchReply();
+      if (shellAtBinary) {
+        uint8_t payload[FRAME_MAX_PAYLOAD];
+        byte length = 1;
+        payload[0] = reply[0] != '\0' ? SHELL_STATUS_OK : SHELL_STATUS_BUSY;
+        while (reply[length - 1] != '\0' && length < sizeof(payload)) {
+          payload[length] = reply[length - 1];
+          length++;
+        }
+        shellReply(SHELL_OP_AT, payload, length);
+      } else {
+        if (reply[0] != '\0') {
+          Serial.println(reply);
+        } else {
+          Serial.println(F("No response from HC-12."));
+        }
+      }
+      shellAtPending = false;
+    }
+  }
+
+  if (shellLinkPending && !linkSwitchBusy()) {
+    if (shellLinkBinary) {
+      uint8_t status = SHELL_STATUS_OK;
+      shellReply(SHELL_OP_LINK, &status, 1);
+    } else {
+      Serial.println(F("OK"));
+    }
+    shellLinkPending = false;
+  }
+
+#if RADIO_TRACE
+  if (traceDumpActive) {
+    loopTraceDump();
+  }
+#endif
+}
+
+/*
+*@brief Function to pass bytes between the serial monitor and the HC-12 in AT mode, call once per loop while bridging
+*@details Announces the return to normal mode, in binary mode with a second SHELL_OP_BRIDGE status reply.
+*/
+void loopBridge() {
+  channelSwitchPoll(millis());
+  if (channelSwitchBridging()) {
+    return;
+  }
+  if (bridgeBinary) {
+    uint8_t status = SHELL_STATUS_OK;
+    shellReply(SHELL_OP_BRIDGE, &status, 1);
+  } else {
+    Serial.println(F("HC-12 back in normal mode."));
+  }
+}
+
+/*
+* @brief Function to setup IO pins for button, LED and buzzer
+*/
+void setupIoPins() {
+  pinMode(BUTTON_PIN, INPUT_PULLUP);                     // Set button pin as input with pull-up resistor
+  pinMode(LED_PIN, OUTPUT);                              // Set LED pin as output
+  pinMode(BUZZER_PIN, OUTPUT);                           // Set buzzer pin as output
+
+  digitalWrite(LED_PIN, LOW);                            // Ensure LED is off at startup
+  digitalWrite(BUZZER_PIN, LOW);                         // Ensure buzzer is off at startup
+
+  Serial.println(F("-----------------------------------"));
+  Serial.println(F("IO Pins Initialized"));
+  Serial.print(F("Board: "));
+  Serial.println(BOARD_NAME);
+  Serial.print(F("Button Pin: "));
+  Serial.println(BUTTON_PIN);
+  Serial.print(F("LED Pin: "));
+  Serial.println(LED_PIN);
+  Serial.print(F("Buzzer Pin: "));
+  Serial.println(BUZZER_PIN);
+  Serial.println(F("-----------------------------------"));
+}
+
+/*
+*@brief Function to measure frame delivery through a loopback link at increasing error rates
+*@details For every rate the same seeded frames are sent through the fault injector and a loopback stream of its own
+*         and parsed on the other side. Throughput counts all bytes on the air, goodput only the payload of frames that
+*         arrived intact. Undetected are frames that passed the CRC with a damaged payload.
+*/
+void runFaultSweep() {
+  const uint8_t rates[] = {0, 1, 2, 5, 10, 20};
+  const byte frameCount = 50;
+  const byte payloadLength = 16;
+  LoopbackStream loopback(9600, 4000);                // Only for the sweep, on the stack while it runs
+
+  Serial.println(F("Error%  Air Bytes  Intact  Dropped  Undetected  Throughput B/s  Goodput B/s"));
+  for (byte r = 0; r < sizeof(rates); r++) {
+    FaultInjector faults;
+    FrameParser parser;
+    unsigned long intact = 0;
+    unsigned long dropped = 0;
+    unsigned long undetected = 0;
+
+    faultInit(faults, faultConfigForRate(rates[r]), faultInjectionSeed);
+    frameParserReset(parser);
+    unsigned long start = millis();
+
+    for (byte f = 0; f < frameCount; f++) {
+      uint8_t payload[payloadLength];
+      for (byte i = 0; i < payloadLength; i++) {
+        payload[i] = f * 7 + i;
+      }
+
+      uint8_t frame[FRAME_MAX_SIZE];
+      uint8_t damaged[2 * FRAME_MAX_SIZE];
+      byte size = frameEncode(FRAME_TEXT, payload, payloadLength, frame);
+      loopback.write(damaged, faultApply(faults, frame, size, damaged));
+
+      while (loopback.pending() > 0) {                // Wait for the burst to cross the simulated link
+        if (loopback.available()) {
+          int8_t result = frameParserFeed(parser, loopback.read());
+          if (result == FRAME_COMPLETE) {
+            if (parser.frame.length == payloadLength && memcmp(parser.frame.payload, payload, payloadLength) == 0) {
+              intact++;
+            } else {
+              undetected++;
+            }
+          } else if (result == FRAME_ERROR) {
+            dropped++;
+          }
+        }
+      }
+    }
+
+    unsigned long elapsed = max(millis() - start, 1UL);
+    Serial.print(rates[r]);
+    Serial.print(F("       "));
+    Serial.print(faults.stats.bytesOut);
+    Serial.print(F("       "));
+    Serial.print(intact);
+    Serial.print(F("      "));
+    Serial.print(dropped);
+    Serial.print(F("        "));
+    Serial.print(undetected);
+    Serial.print(F("           "));
+    Serial.print(faults.stats.bytesOut * 1000UL / elapsed);
+    Serial.print(F("            "));
+    Serial.println(intact * payloadLength * 1000UL / elapsed);
+  }
+}
+
+
+void setup() {
+  Serial.begin(9600);                                 // Start Serial communication for debugging
+  setupIoPins();                                      // Setup IO pins for button, LED and buzzer
+  latencyProbeBegin();                                // Marker pins for a logic analyzer, only with LATENCY_PROBE
+  morseTimingCompute(keyingTiming, keyingWpm, 0);     // Thresholds for classifying presses and pauses
+  setupHcTestMode();
+  if (dspBenchmarkMode) {
+    dspBenchmarkRun();                                // Print DSP kernel checksums and cycle counts
+  }
+  if (faultSweepMode) {
+    runFaultSweep();                                  // Print frame throughput and goodput against error rate
+  }
+  if (provisionLinkKey) {
+    keyStoreSave(linkKeyToProvision);
+    Serial.println(F("Link key stored in EEPROM."));
+  }
+#if SECURE_FRAMES
+  uint8_t key[SECURE_KEY_SIZE];
+  linkKeyLoaded = keyStoreLoad(key);
+  if (linkKeyLoaded) {
+    secureKeyInit(linkKey, key);
+    secureCounter = keyStoreSendCounter();            // Above every counter used before the reset
+    secureCounterReserved = secureCounter;            // The first frame reserves a batch
+    replayFloorSaved = keyStoreReceiveFloor();
+    replayInit(replayWindow, replayFloorSaved);
+    counterSyncDue = true;                            // The other device may be counting below the floor
+  } else {
+    Serial.println(F("No link key in EEPROM, nothing will be sent or accepted."));
+  }
+#endif
+  if (cryptBenchmarkMode) {
+    cryptBenchmarkRun();                              // Print the encryption test results and cycle counts
+  }
+  rxParserReset(radioParser);
+  shellReset(shell);
+  applyPlaybackWpm();                                 // Playback timing for the playback queue
+  if (playbackSpeedup) {
+    playbackSetSpeedup(speedupStartDepth, speedupFullDepth, speedupMinPercent, speedupMinDuration);
+  }
+  faultInit(radioFaults, faultConfigForRate(faultInjectionPercent), faultInjectionSeed);
+  elementStreamInit(keyedStream, keyedStreamBits, sizeof(keyedStreamBits));
+  beamDecoderInit(keyingTiming.dot);                  // Start from the dot of keyingWpm
+  if (scriptedKeying) {
+    keyScriptStart(parisScript, sizeof(parisScript) / sizeof(parisScript[0]), true);
+  }
+#if TONE_INPUT
+  toneInputBegin(TONE_INPUT_PIN, toneInputFrequency); // Sample the audio input in the background
+#endif
+
+
+  // Initialize HC-12 module
+  if(setupHc12()) {                                   // If HC-12 setup is successful beep and buzz for 200 milliseconds for 5 times
+    Serial.println(F("HC-12 setup successful."));
+    beepAndBuzz(5, 200);
+  } else {                                            // If HC-12 setup fails beep and buzz for 3 seconds three time 
+    beepAndBuzz(3, 3000);                               
+    Serial.println(F("HC-12 setup failed."));
+  }
+
+  channelSwitchBegin(morse, HC12_SET_PIN);            // AT commands from the serial monitor, channel hops
+  if (throughputBenchmarkMode) {
+    startThroughputBenchmark();                       // Runs from loop(), needs the other device running, or LOOPBACK_TEST
+  }
+#if FREQUENCY_HOPPING
+  hopInit(hopSchedule, hopSeed, hopChannels, sizeof(hopChannels));
+  hopSynced = isInitiator;
+  hopSlotStart = millis();
+  channelSwitchStart(hopTuneChannel(), hopSlotStart);
+#else
+  if (channelScanMode) {
+    channelScanBegin(morse, HC12_SET_PIN, scanChannels, sizeof(scanChannels), scanDwell, scanActivityHold);
+  }
+#endif
+
+}
+
+
+
+void loop() {
+  if (channelSwitchBridging()) {
+    loopBridge();                                                      // The serial monitor has the HC-12 to itself
+    loopPlayback();                                                    // Everything else, queued messages too, waits
+    loopBeep();
+    return;
+  }
+  loopBuzzerLedAndButtonTest();                                        // Test buzzer, LED and button functionality if enabled
+  loopHcTestMode();                                                    // Loop for HC-12 test mode if enabled      
+  loopGestures();                                                      // Run command mode commands keyed with the button
+  loopLinkSwitch();                                                    // Run a link profile switch without blocking
+  loopBenchmark();                                                     // Profile switches and reports for the other device's benchmark
+  loopThroughputBenchmark();                                           // Run a throughput benchmark started on this device
+#if FREQUENCY_HOPPING
+  loopHopping();                                                       // Hop on schedule and exchange beacons
+#else
+  if (channelScanMode) {
+    channelScanPoll(millis(), morse.available() > 0 || channelSwitchPending() > 0); // Hop unless this channel is busy
+  }
+#endif
+  loopPlayback();                                                      // Play received Morse without blocking
+  loopBeep();                                                          // Beeps of beepAndBuzz()
+  loopCredit();                                                        // Tell the other device how much more it may send
+  loopTransmit();                                                      // Send messages the other device now has room for
+#if SECURE_FRAMES
+  loopCounterSync();                                                   // Bring the other device's counter above the receive floor
+#endif
+  if (serialShellEnabled) {
+    loopShell();                                                       // Commands from the serial monitor
+  } else if (scriptedKeying) {
+    loopKeyScript();                                                   // Replace the key script with one from the serial monitor
+  }
+  loopStatsDump();                                                     // Print the statistics as the serial port has room
+#if TONE_INPUT
+  loopToneInput();                                                     // Key elements from the tone input
+#endif
+  if (sendMode == SEND_CHARACTERS) {
+    loopCharacterMode();                                               // Send characters and words once the keying pauses
+  } else if (sendMode == SEND_ELEMENT_STREAM) {
+    loopElementStream();                                               // Send the elements of a character once the keying pauses
+  }
+
+  // Priority is listen mode, button cannot be pressed while receiving morse code from other devices
+  // System is designed to receive morse code from other devices and send morse code when button is pressed
+  // Where 1 is dot and 2 is dash
+  // If morse code is received, it will be beeped and buzzed
+  bool receiving = radioAvailable();
+  if (receiving) {
+    receiveRadio();                                                     // Element lines and frames from the HC-12
+  }
+  if (keyPressed || (!receiving && !playbackBusy())) {
+    //Listen for button press if no morse code is available to output, a press already started is timed to its end
     morseToSend = talkMorse ();                                         // Call the function to check if the button is pressed and get the morse code to send
 
-    if (morseToSend > 0) {                                              // If the button press is valid, it will be either 1 or 2  
-      Serial.print("Sending: ");
-      Serial.println(morseToSend);
-      morse.println(morseToSend);                                       // Send the morse value via HC-12
+    if (morseToSend > 0) {                                              // If the button press is valid, it will be either 1 or 2
+      keyElement(morseToSend);
     }
   }
 }
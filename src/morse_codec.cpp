@@ -0,0 +1,87 @@
+#include "morse_codec.h"
+#include "pgm_compat.h"
+
+// Morse tree, indexed by packed code. Each level of the tree is one more element.
+static const uint8_t morseTree[128] PROGMEM = {
+  0, 0, 'E', 'T', 'I', 'A', 'N', 'M',                                 // 0-7
+  'S', 'U', 'R', 'W', 'D', 'K', 'G', 'O',                             // 8-15
+  'H', 'V', 'F', 0, 'L', 0, 'P', 'J',                                 // 16-23
+  'B', 'X', 'C', 'Y', 'Z', 'Q', 0, 0,                                 // 24-31
+  '5', '4', MORSE_VE, '3', 0, 0, 0, '2',                              // 32-39
+  MORSE_AS, 0, MORSE_AR, 0, 0, 0, 0, '1',                             // 40-47
+  '6', MORSE_BT, '/', 0, 0, MORSE_CT, MORSE_KN, 0,                    // 48-55
+  '7', 0, 0, 0, '8', 0, '9', '0',                                     // 56-63
+  0, 0, 0, 0, 0, MORSE_SK, 0, 0,                                      // 64-71
+  0, 0, 0, 0, '?', '_', 0, 0,                                         // 72-79
+  0, 0, '"', 0, 0, '.', 0, 0,                                         // 80-87
+  0, 0, '@', 0, 0, 0, '\'', 0,                                        // 88-95
+  0, '-', 0, 0, 0, 0, 0, 0,                                           // 96-103
+  0, 0, ';', '!', 0, ')', 0, 0,                                       // 104-111
+  0, 0, 0, ',', 0, 0, 0, 0,                                           // 112-119
+  ':', 0, 0, 0, 0, 0, 0, 0,                                           // 120-127
+};
+
+// Packed codes of the printable characters from ' ' to '_', 0 where there is none
+static const uint8_t morseCharacterCodes[64] PROGMEM = {
+  0, 0x6B, 0x52, 0, 0, 0, 0x28, 0x5E,                                 // ' '-'\''
+  0x36, 0x6D, 0, 0x2A, 0x73, 0x61, 0x55, 0x32,                        // '('-'/'
+  0x3F, 0x2F, 0x27, 0x23, 0x21, 0x20, 0x30, 0x38,                     // '0'-'7'
+  0x3C, 0x3E, 0x78, 0x6A, 0, 0x31, 0, 0x4C,                           // '8'-'?'
+  0x5A, 0x05, 0x18, 0x1A, 0x0C, 0x02, 0x12, 0x0E,                     // '@'-'G'
+  0x10, 0x04, 0x17, 0x0D, 0x14, 0x07, 0x06, 0x0F,                     // 'H'-'O'
+  0x16, 0x1D, 0x0A, 0x08, 0x03, 0x09, 0x11, 0x0B,                     // 'P'-'W'
+  0x19, 0x1B, 0x1C, 0, 0, 0, 0, 0x4D,                                 // 'X'-'_'
+};
+
+// Packed codes and names of the prosign tokens, in token order
+static const uint8_t prosignCodes[MORSE_PROSIGN_COUNT] PROGMEM = {0x2A, 0x28, 0x31, 0x35, 0x36, 0x45, 0x22};
+static const char prosignNames[MORSE_PROSIGN_COUNT][3] PROGMEM = {"AR", "AS", "BT", "CT", "KN", "SK", "VE"};
+
+uint8_t morseAppendElement(uint8_t _code, bool _isDash) {
+  if (_code == MORSE_INVALID_CODE || (_code >> MORSE_MAX_ELEMENTS) != 0) {
+    return MORSE_INVALID_CODE;
+  }
+  return (_code << 1) | (_isDash ? 1 : 0);
+}
+
+uint8_t morseCodeLength(uint8_t _code) {
+  uint8_t length = 0;
+  while (_code > 1) {
+    _code >>= 1;
+    length++;
+  }
+  return length;
+}
+
+uint8_t morseDecode(uint8_t _code) {
+  if (_code >= sizeof(morseTree)) {
+    return 0;
+  }
+  return pgm_read_byte(&morseTree[_code]);
+}
+
+uint8_t morseEncode(uint8_t _symbol) {
+  if (_symbol >= 'a' && _symbol <= 'z') {
+    _symbol -= 'a' - 'A';
+  }
+
+  if (_symbol >= ' ' && _symbol <= '_') {
+    return pgm_read_byte(&morseCharacterCodes[_symbol - ' ']);
+  }
+
+  if (_symbol >= MORSE_PROSIGN && _symbol < MORSE_PROSIGN + MORSE_PROSIGN_COUNT) {
+    return pgm_read_byte(&prosignCodes[_symbol - MORSE_PROSIGN]);
+  }
+
+  return MORSE_INVALID_CODE;
+}
+
+bool morseProsignName(uint8_t _token, char* _name) {
+  if (_token < MORSE_PROSIGN || _token >= MORSE_PROSIGN + MORSE_PROSIGN_COUNT) {
+    _name[0] = 0;
+    return false;
+  }
+
+  memcpy_P(_name, prosignNames[_token - MORSE_PROSIGN], sizeof(prosignNames[0]));
+  return true;
+}
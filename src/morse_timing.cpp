@@ -0,0 +1,19 @@
+#include "morse_timing.h"
+
+void morseTimingCompute(MorseTiming& _timing, uint8_t _wpm, uint8_t _farnsworthWpm) {
+  uint16_t dot = 1200 / (_wpm > 0 ? _wpm : 1);
+
+  _timing.dot = dot;
+  _timing.dash = 3 * dot;
+  _timing.characterGap = 3 * dot;
+  _timing.wordGap = 7 * dot;
+
+  if (_farnsworthWpm == 0 || _farnsworthWpm >= _wpm) {
+    return;
+  }
+
+  // Total added delay per word: ta = (60 c - 37.2 s) / (s c) seconds, shared 3:7 between the 19 gap units of PARIS
+  uint32_t delay = (60000UL * _wpm - 37200UL * _farnsworthWpm) / ((uint32_t)_farnsworthWpm * _wpm);
+  _timing.characterGap = 3 * delay / 19;
+  _timing.wordGap = 7 * delay / 19;
+}
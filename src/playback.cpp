@@ -0,0 +1,132 @@
+#include "element_stream.h"
+#include "playback.h"
+
+static_assert(PLAYBACK_QUEUE_SIZE == 256, "Queue indices are bytes that wrap with the queue");
+
+static const uint8_t IDLE = 0;
+static const uint8_t SOUNDING = 1;
+static const uint8_t SILENT = 2;
+
+static uint8_t queue[PLAYBACK_QUEUE_SIZE / 4];        // Items packed like an element stream
+static uint8_t head = 0;                              // Index of the next item to play, wraps with the queue
+static uint16_t count = 0;
+static PlaybackTiming timing = {200, 600, 1200, 400, 800};
+static uint16_t speedupStart = PLAYBACK_QUEUE_SIZE;  // Queued items at which speed-up starts
+static uint16_t speedupFull = PLAYBACK_QUEUE_SIZE;
+static uint8_t speedupMinPercent = 100;
+static uint16_t speedupMinDuration = 0;
+static uint8_t speedPercent = 100;                    // Scale of the item playing
+static uint8_t phase = IDLE;
+static unsigned long phaseEnd = 0;                    // Time the current phase ends
+
+void playbackReset() {
+  head = 0;
+  count = 0;
+  phase = IDLE;
+}
+
+void playbackSetTiming(const PlaybackTiming& _timing) {
+  timing = _timing;
+}
+
+void playbackSetSpeedup(uint16_t _startDepth, uint16_t _fullDepth, uint8_t _minPercent, uint16_t _minDuration) {
+  speedupStart = _startDepth;
+  speedupFull = _fullDepth > _startDepth ? _fullDepth : _startDepth + 1;
+  speedupMinPercent = _minPercent;
+  speedupMinDuration = _minDuration;
+}
+
+uint8_t playbackSpeedPercent() {
+  return speedPercent;
+}
+
+/*
+@brief Duration scale for the current backlog, falling linearly from 100% at speedupStart to the minimum at speedupFull
+*/
+static uint8_t backlogPercent() {
+  if (count <= speedupStart) {
+    return 100;
+  }
+  if (count >= speedupFull) {
+    return speedupMinPercent;
+  }
+  return 100 - (uint32_t)(100 - speedupMinPercent) * (count - speedupStart) / (speedupFull - speedupStart);
+}
+
+/*
+@brief Scale a duration, never below speedupMinDuration unless it was shorter already
+*/
+static uint16_t scaled(uint16_t _duration) {
+  uint16_t duration = (uint32_t)_duration * speedPercent / 100;
+  uint16_t floor = _duration < speedupMinDuration ? _duration : speedupMinDuration;
+  return duration > floor ? duration : floor;
+}
+
+bool playbackPush(uint8_t _item) {
+  if (count >= PLAYBACK_QUEUE_SIZE) {
+    return false;
+  }
+
+  uint8_t index = head + count;                       // Wraps at 256 together with the queue
+  uint8_t shift = (index & 3) << 1;
+  queue[index >> 2] = (queue[index >> 2] & ~(3 << shift)) | ((_item & 3) << shift);
+  count++;
+  return true;
+}
+
+uint16_t playbackQueued() {
+  return count;
+}
+
+uint16_t playbackFree() {
+  return PLAYBACK_QUEUE_SIZE - count;
+}
+
+bool playbackBusy() {
+  return phase != IDLE || count > 0;
+}
+
+/*
+@brief Start the next phase where the current one ended, or now if playback was idle or the loop fell behind
+*/
+static void nextPhase(uint8_t _phase, uint16_t _duration, unsigned long _now) {
+  unsigned long start = phase == IDLE || _now - phaseEnd > timing.dot ? _now : phaseEnd;
+  phase = _phase;
+  phaseEnd = start + _duration;
+}
+
+uint8_t playbackUpdate(unsigned long _now) {
+  if (phase != IDLE && (long)(_now - phaseEnd) < 0) {
+    return PLAYBACK_NONE;
+  }
+
+  if (phase == SOUNDING) {
+    nextPhase(SILENT, scaled(timing.elementGap), _now);
+    return PLAYBACK_OFF;
+  }
+
+  if (count == 0) {
+    phase = IDLE;
+    return PLAYBACK_NONE;
+  }
+
+  speedPercent = backlogPercent();                    // The whole item, including its gap, plays at one speed
+  uint8_t item = elementStreamItem(queue, head);
+  head++;
+  count--;
+
+  switch (item) {
+    case ELEMENT_DOT:
+      nextPhase(SOUNDING, scaled(timing.dot), _now);
+      return PLAYBACK_ON;
+    case ELEMENT_DASH:
+      nextPhase(SOUNDING, scaled(timing.dash), _now);
+      return PLAYBACK_ON;
+    case ELEMENT_CHARACTER_GAP:
+      nextPhase(SILENT, scaled(timing.characterGap), _now);
+      return PLAYBACK_NONE;
+    default:
+      nextPhase(SILENT, scaled(timing.wordGap), _now);
+      return PLAYBACK_NONE;
+  }
+}
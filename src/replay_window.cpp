@@ -0,0 +1,47 @@
+#include "replay_window.h"
+
+void replayInit(ReplayWindow& _window, uint32_t _floor) {
+  _window.top = _floor - 1;                           // Counters compare with wraparound, so a floor of 0 works too
+  _window.seen = 0xFFFFFFFFUL;                        // Nothing below the floor is fresh
+}
+
+bool replayCheck(const ReplayWindow& _window, uint32_t _counter) {
+  if ((int32_t)(_counter - _window.top) > 0) {
+    return true;
+  }
+
+  uint32_t age = _window.top - _counter;
+  return age < REPLAY_WINDOW_SIZE && !(_window.seen & (1UL << age));
+}
+
+void replayAccept(ReplayWindow& _window, uint32_t _counter) {
+  if ((int32_t)(_counter - _window.top) > 0) {
+    uint32_t shift = _counter - _window.top;
+    _window.seen = shift < REPLAY_WINDOW_SIZE ? (_window.seen << shift) | 1 : 1;
+    _window.top = _counter;
+    return;
+  }
+
+  uint32_t age = _window.top - _counter;
+  if (age < REPLAY_WINDOW_SIZE) {
+    _window.seen |= 1UL << age;
+  }
+}
+
+uint32_t replayNext(const ReplayWindow& _window) {
+  return _window.top + 1;
+}
+
+uint32_t replayFloorAfter(uint32_t _floor, uint32_t _counter) {
+  if ((int32_t)(_counter - _floor) < 0) {
+    return _floor;
+  }
+  return (_counter / REPLAY_BATCH + 1) * REPLAY_BATCH;
+}
+
+uint32_t replayReserve(uint32_t _reserved, uint32_t _next) {
+  if ((int32_t)(_next - _reserved) < 0) {
+    return _reserved;
+  }
+  return _next + REPLAY_BATCH;
+}
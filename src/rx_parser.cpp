@@ -0,0 +1,71 @@
+#include "rx_parser.h"
+
+void rxParserReset(RxParser& _parser) {
+  frameParserReset(_parser.frame);
+  _parser.frame.frame.length = 0;
+  _parser.line[0] = '\0';
+  _parser.lineLength = 0;
+  _parser.lineOverflow = false;
+  _parser.element = 0;
+}
+
+bool rxParserBusy(const RxParser& _parser) {
+  return frameParserBusy(_parser.frame) || _parser.lineLength > 0 || _parser.lineOverflow;
+}
+
+/*
+@brief Classify a completed line and start the next one
+*/
+static uint8_t endLine(RxParser& _parser) {
+  uint8_t length = _parser.lineLength;
+  bool overflow = _parser.lineOverflow;
+
+  _parser.line[length] = '\0';
+  _parser.lineLength = 0;
+  _parser.lineOverflow = false;
+
+  if (length == 0 && !overflow) {                     // Blank line, e.g. a lone '\n'
+    return RX_NONE;
+  }
+  if (!overflow && length == 1 && (_parser.line[0] == '1' || _parser.line[0] == '2')) {
+    _parser.element = _parser.line[0] - '0';
+    return RX_ELEMENT;
+  }
+  return RX_INVALID;
+}
+
+uint8_t rxParserFeed(RxParser& _parser, uint8_t _byte) {
+  if (_byte == FRAME_START && !frameParserBusy(_parser.frame)) {
+    _parser.lineLength = 0;                           // Never part of an element line, so the rest of a damaged
+    _parser.lineOverflow = false;                     // frame before it is dropped and the next frame is received
+  }
+
+  if (frameParserBusy(_parser.frame) || _byte == FRAME_START) {
+    int8_t result = frameParserFeed(_parser.frame, _byte);
+    if (result == FRAME_COMPLETE) {
+      return RX_FRAME;
+    }
+    return result == FRAME_ERROR ? RX_FRAME_ERROR : RX_NONE;
+  }
+
+  if (_byte == '\n') {
+    return endLine(_parser);
+  }
+  if (_byte == '\r') {                                // println() line ending
+    return RX_NONE;
+  }
+
+  if (_parser.lineLength < RX_LINE_MAX) {
+    _parser.line[_parser.lineLength++] = (char)_byte;
+  } else {
+    _parser.lineOverflow = true;                      // Keep reading up to the line end but drop the rest
+  }
+  _parser.line[_parser.lineLength] = '\0';
+  return RX_NONE;
+}
+
+bool rxParserValid(const RxParser& _parser) {
+  const FrameParser& frame = _parser.frame;
+
+  return _parser.lineLength <= RX_LINE_MAX && frame.frame.length <= FRAME_MAX_WIRE_PAYLOAD && frame.index <= frame.frame.length;
+}
@@ -0,0 +1,155 @@
+#include <string.h>
+#include "secure_frame.h"
+
+static const uint8_t FLAGS_MAC = 0x49;                // First CBC-MAC block, never equal to a counter block
+static const uint8_t FLAGS_COUNTER = 0x01;            // Counter mode blocks
+
+// Speck64 only rotates right by 8 and left by 3, written so that avr-gcc moves bytes instead of looping over shifts
+static inline uint32_t rotateRight8(uint32_t _value) {
+  return (_value >> 8) | ((uint32_t)(uint8_t)_value << 24);
+}
+
+static inline uint32_t rotateLeft3(uint32_t _value) {
+  return (_value << 3) | ((uint8_t)(_value >> 24) >> 5);
+}
+
+void secureKeyInit(SecureKey& _key, const uint8_t* _key128) {
+  uint32_t words[4];
+  memcpy(words, _key128, sizeof(words));              // Little endian words, as in the Speck reference
+
+  uint32_t k = words[0];
+  uint32_t l[3] = {words[1], words[2], words[3]};
+  for (uint8_t i = 0; i < SPECK_ROUNDS; i++) {
+    _key.roundKeys[i] = k;
+    uint32_t next = (k + rotateRight8(l[i % 3])) ^ i;
+    k = rotateLeft3(k) ^ next;
+    l[i % 3] = next;
+  }
+}
+
+void speckEncrypt(const SecureKey& _key, uint32_t* _block) {
+  uint32_t y = _block[0];
+  uint32_t x = _block[1];
+
+  for (uint8_t i = 0; i < SPECK_ROUNDS; i++) {
+    x = (rotateRight8(x) + y) ^ _key.roundKeys[i];
+    y = rotateLeft3(y) ^ x;
+  }
+  _block[0] = y;
+  _block[1] = x;
+}
+
+/*
+@brief Fill a block with the flags, the counter and a 16 bit value, then encrypt it
+*/
+static void encryptHeader(const SecureKey& _key, uint8_t _flags, uint32_t _counter, uint16_t _value, uint32_t* _block) {
+  uint8_t bytes[8] = {_flags, (uint8_t)_counter, (uint8_t)(_counter >> 8), (uint8_t)(_counter >> 16),
+                      (uint8_t)(_counter >> 24), 0, (uint8_t)(_value >> 8), (uint8_t)_value};
+  memcpy(_block, bytes, sizeof(bytes));
+  speckEncrypt(_key, _block);
+}
+
+/*
+@brief CBC-MAC over the length, counter and plaintext
+*/
+static void computeMac(const SecureKey& _key, uint32_t _counter, const uint8_t* _plain, uint8_t _length,
+                       uint32_t* _mac) {
+  encryptHeader(_key, FLAGS_MAC, _counter, _length, _mac);
+  for (uint8_t i = 0; i < _length; i += 8) {
+    uint8_t block[8] = {0};
+    memcpy(block, _plain + i, _length - i < 8 ? _length - i : 8);
+
+    uint32_t words[2];
+    memcpy(words, block, sizeof(words));
+    _mac[0] ^= words[0];
+    _mac[1] ^= words[1];
+    speckEncrypt(_key, _mac);
+  }
+}
+
+/*
+@brief XOR data with the counter mode key stream, blocks 1 and up
+*/
+static void applyKeyStream(const SecureKey& _key, uint32_t _counter, const uint8_t* _in, uint8_t _length,
+                           uint8_t* _out) {
+  for (uint8_t i = 0; i < _length; i += 8) {
+    uint32_t stream[2];
+    uint8_t bytes[8];
+    encryptHeader(_key, FLAGS_COUNTER, _counter, i / 8 + 1, stream);
+    memcpy(bytes, stream, sizeof(bytes));
+
+    for (uint8_t j = 0; j < 8 && i + j < _length; j++) {
+      _out[i + j] = _in[i + j] ^ bytes[j];
+    }
+  }
+}
+
+/*
+@brief Tag from the CBC-MAC, encrypted with counter block 0
+*/
+static void computeTag(const SecureKey& _key, uint32_t _counter, const uint8_t* _plain, uint8_t _length,
+                       uint8_t* _tag) {
+  uint32_t mac[2];
+  uint32_t stream[2];
+  uint8_t macBytes[8];
+  uint8_t streamBytes[8];
+
+  computeMac(_key, _counter, _plain, _length, mac);
+  encryptHeader(_key, FLAGS_COUNTER, _counter, 0, stream);
+  memcpy(macBytes, mac, sizeof(macBytes));
+  memcpy(streamBytes, stream, sizeof(streamBytes));
+  for (uint8_t i = 0; i < SECURE_TAG_SIZE; i++) {
+    _tag[i] = macBytes[i] ^ streamBytes[i];
+  }
+}
+
+uint8_t secureSeal(const SecureKey& _key, uint32_t _counter, uint8_t _type, const uint8_t* _payload, uint8_t _length,
+                   uint8_t* _out) {
+  if (_length > FRAME_MAX_PAYLOAD) {
+    return 0;
+  }
+
+  uint8_t plain[FRAME_MAX_PAYLOAD + 1];
+  uint8_t plainLength = _length + 1;
+  plain[0] = _type;
+  memcpy(plain + 1, _payload, _length);
+
+  for (uint8_t i = 0; i < 4; i++) {
+    _out[i] = (uint8_t)(_counter >> (8 * i));
+  }
+  applyKeyStream(_key, _counter, plain, plainLength, _out + 4);
+  computeTag(_key, _counter, plain, plainLength, _out + 4 + plainLength);
+
+  return plainLength + FRAME_SECURE_OVERHEAD - 1;
+}
+
+bool secureOpen(const SecureKey& _key, const uint8_t* _data, uint8_t _length, uint32_t* _counter, Frame& _inner) {
+  if (_length < FRAME_SECURE_OVERHEAD || _length > FRAME_MAX_WIRE_PAYLOAD) {
+    return false;
+  }
+
+  uint32_t counter = 0;
+  for (uint8_t i = 0; i < 4; i++) {
+    counter |= (uint32_t)_data[i] << (8 * i);
+  }
+
+  uint8_t plain[FRAME_MAX_PAYLOAD + 1];
+  uint8_t plainLength = _length - FRAME_SECURE_OVERHEAD + 1;
+  applyKeyStream(_key, counter, _data + 4, plainLength, plain);
+
+  uint8_t tag[SECURE_TAG_SIZE];
+  uint8_t difference = 0;
+  computeTag(_key, counter, plain, plainLength, tag);
+  for (uint8_t i = 0; i < SECURE_TAG_SIZE; i++) {     // Look at every byte, the time taken tells nothing
+    difference |= tag[i] ^ _data[4 + plainLength + i];
+  }
+  if (difference != 0) {
+    return false;
+  }
+
+  *_counter = counter;
+  _inner.type = plain[0];
+  _inner.length = plainLength - 1;
+  memcpy(_inner.payload, plain + 1, _inner.length);
+  return true;
+}
@@ -0,0 +1,121 @@
+#include "serial_shell.h"
+
+struct CommandName {
+  char name[7];
+  uint8_t opcode;
+};
+
+static const CommandName commandNames[] = {
+  {"help", SHELL_OP_HELP},
+  {"stats", SHELL_OP_STATS},
+  {"wpm", SHELL_OP_WPM},
+  {"link", SHELL_OP_LINK},
+  {"at", SHELL_OP_AT},
+  {"bridge", SHELL_OP_BRIDGE},
+  {"trace", SHELL_OP_TRACE},
+  {"key", SHELL_OP_KEY},
+};
+
+void shellReset(ShellParser& _parser) {
+  frameParserReset(_parser.frame);
+  _parser.line[0] = '\0';
+  _parser.lineLength = 0;
+  _parser.lineOverflow = false;
+}
+
+/*
+@brief Look up the command name at the start of a completed line and point the argument past it
+*/
+static uint8_t endLine(ShellParser& _parser) {
+  uint8_t length = _parser.lineLength;
+  bool overflow = _parser.lineOverflow;
+
+  _parser.line[length] = '\0';
+  _parser.lineLength = 0;
+  _parser.lineOverflow = false;
+
+  if (overflow) {
+    return SHELL_ERROR;
+  }
+
+  uint8_t start = 0;
+  while (start < length && _parser.line[start] == ' ') {
+    start++;
+  }
+  uint8_t end = start;
+  while (end < length && _parser.line[end] != ' ') {
+    end++;
+  }
+  if (end == start) {                                 // Blank line
+    return SHELL_NONE;
+  }
+
+  for (uint8_t i = 0; i < sizeof(commandNames) / sizeof(commandNames[0]); i++) {
+    const char* name = commandNames[i].name;
+    uint8_t j = 0;
+    while (start + j < end && name[j] != '\0' && (_parser.line[start + j] | 0x20) == name[j]) {
+      j++;
+    }
+    if (start + j == end && name[j] == '\0') {
+      while (end < length && _parser.line[end] == ' ') {
+        end++;
+      }
+      _parser.command.opcode = commandNames[i].opcode;
+      _parser.command.binary = false;
+      _parser.command.argument = (const uint8_t*)_parser.line + end;
+      _parser.command.argumentLength = length - end;
+      return SHELL_COMMAND;
+    }
+  }
+  return SHELL_ERROR;
+}
+
+uint8_t shellFeed(ShellParser& _parser, uint8_t _byte) {
+  bool lineStart = _parser.lineLength == 0 && !_parser.lineOverflow;
+
+  if (frameParserBusy(_parser.frame) || (lineStart && _byte == FRAME_START)) {
+    int8_t result = frameParserFeed(_parser.frame, _byte);
+    if (result == FRAME_COMPLETE) {
+      const Frame& frame = _parser.frame.frame;
+      _parser.command.opcode = frame.type;
+      _parser.command.binary = true;
+      _parser.command.argument = frame.payload;
+      _parser.command.argumentLength = frame.length;
+      return SHELL_COMMAND;
+    }
+    return result == FRAME_ERROR ? SHELL_ERROR : SHELL_NONE;
+  }
+
+  if (_byte == '\n') {
+    return endLine(_parser);
+  }
+  if (_byte == '\r') {                                // Serial monitor line ending
+    return SHELL_NONE;
+  }
+
+  if (_parser.lineLength < SHELL_LINE_MAX) {
+    _parser.line[_parser.lineLength++] = (char)_byte;
+  } else {
+    _parser.lineOverflow = true;                      // Keep reading up to the line end but drop the rest
+  }
+  return SHELL_NONE;
+}
+
+bool shellNumber(const uint8_t* _argument, uint8_t _length, uint16_t* _value) {
+  uint32_t value = 0;
+
+  if (_length == 0) {
+    return false;
+  }
+  for (uint8_t i = 0; i < _length; i++) {
+    if (_argument[i] < '0' || _argument[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (_argument[i] - '0');
+    if (value > 0xFFFF) {
+      return false;
+    }
+  }
+  *_value = (uint16_t)value;
+  return true;
+}
@@ -0,0 +1,149 @@
+#include "text_compress.h"
+#include "morse_codec.h"
+#include "pgm_compat.h"
+
+// Word table of common QSO vocabulary. Entries must stay in ASCII order for the binary search in textFindWord().
+// Both devices must use the same table, the index is sent on air. At most 96 entries fit after TEXT_WORD.
+static const char words[][TEXT_MAX_WORD_LENGTH + 1] PROGMEM = {
+  "599", "5NN", "73", "88", "ABT", "AGN", "ALL", "AND", "ANT", "BAND", "BEST", "BK", "CALL",
+  "CHECK", "CLOUD", "CONDX", "COPY", "CPY", "CQ", "CUL", "DE", "DX", "ES", "FB", "FER", "FOR",
+  "FROM", "GA", "GE", "GM", "GN", "GOOD", "GUD", "HAM", "HI", "HPE", "HR", "HRD", "HW", "INFO",
+  "IS", "LUCK", "MY", "NAME", "NET", "NO", "NR", "OK", "OM", "OP", "OUT", "OVER", "PSE", "PWR",
+  "QRL", "QRM", "QRN", "QRO", "QRP", "QRQ", "QRS", "QRT", "QRV", "QRX", "QRZ", "QSB", "QSL", "QSO",
+  "QSY", "QTH", "RIG", "ROGER", "RPT", "RST", "SIG", "SOON", "SRI", "SUNNY", "TEMP", "TEST",
+  "THANK", "THE", "THIS", "TNX", "TU", "UP", "UR", "VY", "WATTS", "WID", "WX", "XYL", "YES",
+  "YL", "YOUR",
+};
+static const uint8_t wordCount = sizeof(words) / sizeof(words[0]);
+static_assert(sizeof(words) / sizeof(words[0]) <= 0x100 - TEXT_WORD, "Word table has more entries than codes");
+
+/*
+@brief Compare a word with a word table entry like strcmp()
+*/
+static int8_t compareWord(const uint8_t* _word, uint8_t _length, uint8_t _index) {
+  for (uint8_t i = 0; i <= TEXT_MAX_WORD_LENGTH; i++) {
+    uint8_t entry = pgm_read_byte(&words[_index][i]);
+    uint8_t c = i < _length ? _word[i] : 0;
+
+    if (c != entry) {
+      return c < entry ? -1 : 1;
+    }
+    if (c == 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/*
+@brief Check if a byte can be sent as is in compressed text
+*/
+static bool isLiteral(uint8_t _byte) {
+  return (_byte >= ' ' && _byte <= '_') || (_byte >= MORSE_PROSIGN && _byte < MORSE_PROSIGN + MORSE_PROSIGN_COUNT);
+}
+
+int8_t textFindWord(const uint8_t* _word, uint8_t _length) {
+  if (_length == 0 || _length > TEXT_MAX_WORD_LENGTH) {
+    return -1;
+  }
+
+  uint8_t low = 0;
+  uint8_t high = wordCount;
+  while (low < high) {
+    uint8_t middle = (low + high) / 2;
+    int8_t order = compareWord(_word, _length, middle);
+
+    if (order == 0) {
+      return middle;
+    } else if (order < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+  return -1;
+}
+
+uint8_t textCompress(const uint8_t* _text, uint8_t _length, uint8_t* _out, uint8_t _outSize) {
+  uint8_t size = 0;
+  uint8_t i = 0;
+
+  while (i < _length) {
+    uint8_t end = i;
+    while (end < _length && _text[end] != ' ') {
+      end++;
+    }
+
+    int8_t index = textFindWord(&_text[i], end - i);
+    if (index >= 0) {                                 // Whole word from the table
+      if (size >= _outSize) {
+        return 0;
+      }
+      _out[size++] = TEXT_WORD + index;
+      i = end;
+    } else {                                          // Literal characters up to the end of the word
+      for (; i < end; i++) {
+        bool literal = isLiteral(_text[i]);
+        if (size + (literal ? 1 : 2) > _outSize) {
+          return 0;
+        }
+        if (!literal) {
+          _out[size++] = TEXT_ESCAPE;
+        }
+        _out[size++] = _text[i];
+      }
+    }
+
+    if (i < _length) {                                // The space after the word
+      if (size >= _outSize) {
+        return 0;
+      }
+      _out[size++] = ' ';
+      i++;
+    }
+  }
+
+  return size;
+}
+
+uint8_t textExpand(const uint8_t* _data, uint8_t _length, uint8_t* _out, uint8_t _outSize) {
+  uint8_t size = 0;
+
+  for (uint8_t i = 0; i < _length; i++) {
+    uint8_t code = _data[i];
+
+    if (code >= TEXT_WORD) {
+      uint8_t index = code - TEXT_WORD;
+      if (index >= wordCount) {
+        return 0;
+      }
+      for (uint8_t j = 0; j < TEXT_MAX_WORD_LENGTH; j++) {
+        uint8_t c = pgm_read_byte(&words[index][j]);
+        if (c == 0) {
+          break;
+        }
+        if (size >= _outSize) {
+          return 0;
+        }
+        _out[size++] = c;
+      }
+      continue;
+    }
+
+    if (code == TEXT_ESCAPE) {
+      if (++i >= _length) {
+        return 0;
+      }
+      code = _data[i];
+    } else if (!isLiteral(code)) {
+      return 0;
+    }
+
+    if (size >= _outSize) {
+      return 0;
+    }
+    _out[size++] = code;
+  }
+
+  return size;
+}
@@ -0,0 +1,147 @@
+#include "tone_input.h"
+#include "dsp.h"
+#include "feature_flags.h"
+
+#if TONE_INPUT
+
+static const uint32_t MINIMUM_SIGNAL_RATIO = 4;       // A mark must be this many times the noise floor
+static const uint8_t WARMUP_BLOCKS = 16;              // Blocks used to settle the bias and noise floor before detecting
+static const unsigned long BLOCK_DURATION = (unsigned long)TONE_BLOCK_SIZE * 1000UL / TONE_SAMPLE_RATE; // ms
+
+struct MarkRecord {
+  unsigned long start;
+  unsigned long duration;
+};
+
+static DspGoertzel goertzel;                          // Filter tuned to the tone bin
+static int16_t dcLevel = 128 << 4;                    // Running ADC mid level in 1/16 counts
+static unsigned long startTime = 0;                   // Time of the first sample
+
+static uint32_t power = 0;                            // Tone power of the last block
+static uint32_t noiseLevel = 0;                       // Average power while there is no tone
+static uint32_t signalLevel = 0;                      // Average power while there is a tone
+static uint32_t threshold = 0;
+static uint8_t warmupBlocks = 0;                      // Blocks left before detection starts
+static bool rawMark = false;                          // State of the last block before debouncing
+static uint8_t agreeingBlocks = 0;
+static bool mark = false;                             // Debounced state
+static unsigned long markStart = 0;
+
+static MarkRecord markQueue[TONE_MARK_QUEUE_SIZE];
+static uint8_t markHead = 0;
+static uint8_t markTail = 0;
+
+/*
+@brief Run the Goertzel filter over one block of 8-bit samples
+@return Tone power of the block
+*/
+static uint32_t blockPower(const uint8_t* _samples) {
+  for (uint8_t i = 0; i < TONE_BLOCK_SIZE; i++) {
+    dcLevel += _samples[i] - (dcLevel >> 4);          // Remove the bias with a slow running average
+    dspGoertzelUpdate(goertzel, _samples[i] - (dcLevel >> 4)); // Q7, so the Goertzel state fits in 16 bits
+  }
+  return dspGoertzelPower(goertzel);
+}
+
+/*
+@brief Update the adaptive threshold and the debounced state with the power of a finished block
+@param _power Tone power of the block
+@param _endTime Time the block ended in milliseconds
+*/
+static void finishBlock(uint32_t _power, unsigned long _endTime) {
+  power = _power;
+
+  if (warmupBlocks > 0) {
+    warmupBlocks--;
+    noiseLevel = _power;
+    return;
+  }
+
+  // Track the noise floor and the signal level with exponential averages of 1/8
+  if (rawMark) {
+    signalLevel = dspEwma32(signalLevel, _power, 3);
+  } else {
+    noiseLevel = dspEwma32(noiseLevel, _power, 3);
+  }
+
+  uint32_t halfway = noiseLevel + (signalLevel > noiseLevel ? (signalLevel - noiseLevel) / 2 : 0);
+  uint32_t minimum = noiseLevel * MINIMUM_SIGNAL_RATIO + 1;
+  threshold = halfway > minimum ? halfway : minimum;
+
+  bool blockMark = _power > threshold;
+  if (blockMark != rawMark) {
+    rawMark = blockMark;
+    agreeingBlocks = 1;
+  } else if (agreeingBlocks < TONE_DEBOUNCE_BLOCKS) {
+    agreeingBlocks++;
+  }
+
+  if (agreeingBlocks == TONE_DEBOUNCE_BLOCKS && rawMark != mark) {
+    // The state changed when the first agreeing block started
+    unsigned long edge = _endTime - TONE_DEBOUNCE_BLOCKS * BLOCK_DURATION;
+    mark = rawMark;
+
+    if (mark) {
+      markStart = edge;
+    } else {
+      uint8_t next = (markHead + 1) % TONE_MARK_QUEUE_SIZE;
+      if (next != markTail) {                         // Drop the mark if the queue is full
+        markQueue[markHead].start = markStart;
+        markQueue[markHead].duration = edge - markStart;
+        markHead = next;
+      }
+    }
+  }
+}
+
+void toneInputBegin(uint8_t _analogPin, uint16_t _frequency) {
+  // Nearest bin k = N f / fs
+  uint16_t bin = ((uint32_t)TONE_BLOCK_SIZE * _frequency + TONE_SAMPLE_RATE / 2) / TONE_SAMPLE_RATE;
+  dspGoertzelInit(goertzel, dspPhase(bin, TONE_BLOCK_SIZE));
+
+  warmupBlocks = WARMUP_BLOCKS;
+  mark = false;
+  rawMark = false;
+  signalLevel = 0;
+  markHead = markTail = 0;
+  startTime = millis();
+  adcSamplerBegin(_analogPin, TONE_SAMPLE_RATE);
+}
+
+void toneInputEnd() {
+  adcSamplerEnd();
+}
+
+bool toneInputMark() {
+  return mark;
+}
+
+bool toneInputPoll(unsigned long* _start, unsigned long* _duration) {
+  uint32_t sequence;
+  const uint8_t* samples;
+
+  while ((samples = adcSamplerBlock(&sequence)) != NULL) {
+    uint32_t blockPowerValue = blockPower(samples);
+    adcSamplerRelease();                              // The sampler can hand over the next block
+    finishBlock(blockPowerValue, startTime + (sequence + 1) * BLOCK_DURATION);
+  }
+
+  if (markTail == markHead) {
+    return false;
+  }
+
+  *_start = markQueue[markTail].start;
+  *_duration = markQueue[markTail].duration;
+  markTail = (markTail + 1) % TONE_MARK_QUEUE_SIZE;
+  return true;
+}
+
+uint32_t toneInputPower() {
+  return power;
+}
+
+uint32_t toneInputThreshold() {
+  return threshold;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#include "trace.h"
+
+#if RADIO_TRACE
+static TraceEntry entries[TRACE_SIZE];
+static uint8_t next = 0;                              // Where the next event goes
+static uint8_t count = 0;
+
+void traceRecord(uint32_t _time, uint8_t _event, uint8_t _detail) {
+  entries[next].time = _time;
+  entries[next].event = _event;
+  entries[next].detail = _detail;
+  next = (next + 1) % TRACE_SIZE;
+  if (count < TRACE_SIZE) {
+    count++;
+  }
+}
+
+uint8_t traceCount() {
+  return count;
+}
+
+const TraceEntry& traceEntry(uint8_t _index) {
+  return entries[(next + TRACE_SIZE - count + _index) % TRACE_SIZE];
+}
+
+void traceClear() {
+  next = 0;
+  count = 0;
+}
+
+#endif
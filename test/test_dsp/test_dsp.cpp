@@ -0,0 +1,232 @@
+#include <math.h>
+#include <stdint.h>
+#include <unity.h>
+#include "dsp.h"
+#include "dsp_workload.h"
+
+/*
+Host reference implementations of the kernels in dsp.h. The integer references use 64-bit arithmetic with the same
+rounding as the kernels, so they must agree bit for bit as long as no kernel overflows its narrower types. The
+floating point references check that the kernels compute what they claim to.
+*/
+
+static const double PI = 3.14159265358979323846;
+
+static uint32_t referenceSqrt(uint32_t _value) {
+  uint64_t root = (uint64_t)sqrt((double)_value);
+  while (root * root > _value) {
+    root--;
+  }
+  while ((root + 1) * (root + 1) <= _value) {
+    root++;
+  }
+  return (uint32_t)root;
+}
+
+static int16_t referenceEwma(int16_t _average, int16_t _value, uint8_t _shift) {
+  int64_t difference = (int64_t)_value - _average;
+  int64_t step = difference >= 0 ? difference / (1 << _shift) : -((-difference + (1 << _shift) - 1) / (1 << _shift));
+  return (int16_t)(_average + step);                  // Floor division, like an arithmetic shift
+}
+
+struct ReferenceGoertzel {
+  int64_t coefficient;
+  int64_t s1;
+  int64_t s2;
+};
+
+static int64_t floorShift(int64_t _value, uint8_t _shift) {
+  return _value >= 0 ? _value >> _shift : -((-_value + (1LL << _shift) - 1) >> _shift);
+}
+
+static void referenceGoertzelUpdate(ReferenceGoertzel& _filter, int16_t _sample) {
+  int64_t s0 = _sample + floorShift(_filter.coefficient * _filter.s1, 14) - _filter.s2;
+  _filter.s2 = _filter.s1;
+  _filter.s1 = s0;
+}
+
+static uint32_t referenceGoertzelPower(const ReferenceGoertzel& _filter) {
+  int64_t power = _filter.s1 * _filter.s1 + _filter.s2 * _filter.s2 - floorShift(_filter.coefficient * _filter.s1, 14) * _filter.s2;
+  return power > 0 ? (uint32_t)power : 0;
+}
+
+static int16_t referenceBiquad(const DspBiquad& _coefficients, int64_t* _x, int64_t* _y, int16_t _sample) {
+  int64_t accumulator = (int64_t)_coefficients.b0 * _sample + (int64_t)_coefficients.b1 * _x[0] +
+                        (int64_t)_coefficients.b2 * _x[1] - (int64_t)_coefficients.a1 * _y[0] -
+                        (int64_t)_coefficients.a2 * _y[1];
+  accumulator = floorShift(accumulator, 14);
+  if (accumulator > 32767) {
+    accumulator = 32767;
+  } else if (accumulator < -32768) {
+    accumulator = -32768;
+  }
+  _x[1] = _x[0];
+  _x[0] = _sample;
+  _y[1] = _y[0];
+  _y[0] = accumulator;
+  return (int16_t)accumulator;
+}
+
+static uint32_t nextRandom(uint32_t& _state) {
+  _state ^= _state << 13;
+  _state ^= _state >> 17;
+  _state ^= _state << 5;
+  return _state;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_sin_matches_libm() {
+  for (uint32_t phase = 0; phase < 65536; phase++) {
+    int16_t expected = (int16_t)lround(32767 * sin(2 * PI * phase / 65536));
+    TEST_ASSERT_INT_WITHIN(4, expected, dspSin((uint16_t)phase));
+  }
+}
+
+void test_sin_is_odd_and_cos_is_shifted() {
+  for (uint32_t phase = 0; phase < 65536; phase += 7) {
+    TEST_ASSERT_EQUAL_INT16(-dspSin((uint16_t)phase), dspSin((uint16_t)(phase + 0x8000)));
+    TEST_ASSERT_EQUAL_INT16(dspSin((uint16_t)(phase + 0x4000)), dspCos((uint16_t)phase));
+  }
+}
+
+void test_phase_rounds_to_nearest() {
+  TEST_ASSERT_EQUAL_UINT16(11469, dspPhase(700, 4000));          // 700 / 4000 * 65536 = 11468.8
+  TEST_ASSERT_EQUAL_UINT16(16384, dspPhase(1000, 4000));
+  TEST_ASSERT_EQUAL_UINT16(0, dspPhase(0, 4000));
+}
+
+void test_sqrt_is_exact() {
+  const uint32_t edges[] = {0, 1, 2, 3, 4, 15, 16, 17, 65535, 65536, 0x3FFFFFFF, 0x40000000, 0xFFFE0001, 0xFFFFFFFF};
+  for (uint8_t i = 0; i < sizeof(edges) / sizeof(edges[0]); i++) {
+    TEST_ASSERT_EQUAL_UINT32(referenceSqrt(edges[i]), dspSqrt(edges[i]));
+  }
+
+  uint32_t state = 1;
+  for (uint32_t i = 0; i < 100000; i++) {
+    uint32_t value = nextRandom(state) >> (i % 32);
+    TEST_ASSERT_EQUAL_UINT32(referenceSqrt(value), dspSqrt(value));
+  }
+}
+
+void test_ewma_is_exact() {
+  uint32_t state = 2;
+  for (uint32_t i = 0; i < 100000; i++) {
+    int16_t average = (int16_t)nextRandom(state);
+    int16_t value = (int16_t)nextRandom(state);
+    uint8_t shift = i % 15;
+    TEST_ASSERT_EQUAL_INT16(referenceEwma(average, value, shift), dspEwma(average, value, shift));
+  }
+}
+
+void test_ewma32_converges_from_both_sides() {
+  uint32_t up = 0;
+  uint32_t down = 0xFFFFFFFF;
+  for (uint8_t i = 0; i < 200; i++) {
+    up = dspEwma32(up, 1000000, 3);
+    down = dspEwma32(down, 1000000, 3);
+  }
+  TEST_ASSERT_INT_WITHIN(8, 1000000, up);
+  TEST_ASSERT_INT_WITHIN(8, 1000000, down);
+}
+
+void test_goertzel_is_exact() {
+  uint32_t state = 3;
+  for (uint16_t frequency = 300; frequency <= 1500; frequency += 100) {
+    DspGoertzel filter;
+    dspGoertzelInit(filter, dspPhase(frequency, 4000));
+    ReferenceGoertzel reference = {filter.coefficient, 0, 0};
+
+    for (uint8_t i = 0; i < 80; i++) {                              // One tone input block
+      int16_t sample = (int16_t)(nextRandom(state) % 257) - 128;
+      dspGoertzelUpdate(filter, sample);
+      referenceGoertzelUpdate(reference, sample);
+      TEST_ASSERT_EQUAL_INT16(reference.s1, filter.s1);
+    }
+    TEST_ASSERT_EQUAL_UINT32(referenceGoertzelPower(reference), dspGoertzelPower(filter));
+  }
+}
+
+void test_goertzel_detects_its_tone() {
+  const uint8_t block = 80;
+  DspGoertzel filter;
+  dspGoertzelInit(filter, dspPhase(700, 4000));
+
+  for (uint16_t frequency = 300; frequency <= 1500; frequency += 50) {
+    double s1 = 0;
+    double s2 = 0;
+    double coefficient = 2 * cos(2 * PI * 700 / 4000);
+    for (uint8_t i = 0; i < block; i++) {
+      int16_t sample = (int16_t)lround(100 * sin(2 * PI * frequency * i / 4000));
+      dspGoertzelUpdate(filter, sample);
+      double s0 = sample + coefficient * s1 - s2;
+      s2 = s1;
+      s1 = s0;
+    }
+    double expected = s1 * s1 + s2 * s2 - coefficient * s1 * s2;
+    uint32_t power = dspGoertzelPower(filter);
+    TEST_ASSERT_DOUBLE_WITHIN(0.02 * expected + 2000, expected, power);
+  }
+}
+
+void test_biquad_is_exact() {
+  DspBiquad filter;
+  dspBiquadBandpass(filter, dspPhase(700, 4000), 5);
+  int64_t x[2] = {0, 0};
+  int64_t y[2] = {0, 0};
+
+  uint32_t state = 4;
+  for (uint16_t i = 0; i < 10000; i++) {
+    int16_t sample = (int16_t)nextRandom(state);                    // Full scale, saturation included
+    TEST_ASSERT_EQUAL_INT16(referenceBiquad(filter, x, y, sample), dspBiquad(filter, sample));
+  }
+}
+
+void test_biquad_bandpass_response() {
+  for (uint16_t frequency = 200; frequency <= 1800; frequency += 100) {
+    DspBiquad filter;
+    dspBiquadBandpass(filter, dspPhase(700, 4000), 5);
+
+    int32_t peak = 0;
+    for (uint16_t i = 0; i < 4000; i++) {
+      int16_t sample = (int16_t)lround(16000 * sin(2 * PI * frequency * i / 4000));
+      int16_t output = dspBiquad(filter, sample);
+      if (i >= 2000 && abs(output) > peak) {                        // After the filter settled
+        peak = abs(output);
+      }
+    }
+
+    double w = 2 * PI * frequency / 4000;
+    double w0 = 2 * PI * 700 / 4000;
+    double alpha = sin(w0) / 10;
+    double numerator = alpha * 2 * fabs(sin(w));                    // |b0 (1 - z^-2)| on the unit circle
+    double denominatorRe = (1 + alpha) - 2 * cos(w0) * cos(w) + (1 - alpha) * cos(2 * w);
+    double denominatorIm = 2 * cos(w0) * sin(w) - (1 - alpha) * sin(2 * w);
+    double gain = numerator / sqrt(denominatorRe * denominatorRe + denominatorIm * denominatorIm);
+    TEST_ASSERT_DOUBLE_WITHIN(0.03 * 16000 + 40, 16000 * gain, peak);
+  }
+}
+
+void test_workload_checksums() {
+  for (uint8_t i = 0; i < dspWorkloadCount; i++) {
+    dspWorkloadReset();
+    TEST_ASSERT_EQUAL_HEX32_MESSAGE(dspWorkloads[i].expected, dspWorkloads[i].run(), dspWorkloads[i].name);
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_sin_matches_libm);
+  RUN_TEST(test_sin_is_odd_and_cos_is_shifted);
+  RUN_TEST(test_phase_rounds_to_nearest);
+  RUN_TEST(test_sqrt_is_exact);
+  RUN_TEST(test_ewma_is_exact);
+  RUN_TEST(test_ewma32_converges_from_both_sides);
+  RUN_TEST(test_goertzel_is_exact);
+  RUN_TEST(test_goertzel_detects_its_tone);
+  RUN_TEST(test_biquad_is_exact);
+  RUN_TEST(test_biquad_bandpass_response);
+  RUN_TEST(test_workload_checksums);
+  return UNITY_END();
+}
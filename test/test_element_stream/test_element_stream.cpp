@@ -0,0 +1,107 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+#include "element_stream.h"
+
+void setUp() {}
+void tearDown() {}
+
+void test_varint_round_trip() {
+  const uint16_t values[] = {0, 1, 0x7F, 0x80, 0x3FFF, 0x4000, 0xFFFF};
+  for (uint8_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    uint8_t encoded[VARINT_MAX_SIZE];
+    uint16_t decoded = 0;
+    uint8_t size = varintEncode(values[i], encoded);
+    TEST_ASSERT_EQUAL_UINT8(size, varintDecode(encoded, size, &decoded));
+    TEST_ASSERT_EQUAL_UINT16(values[i], decoded);
+    TEST_ASSERT_EQUAL_UINT8(0, varintDecode(encoded, size - 1, &decoded));
+  }
+}
+
+void test_varint_rejects_values_above_16_bits() {
+  const uint8_t tooLarge[] = {0xFF, 0xFF, 0x04};      // 0x1FFFF
+  const uint8_t tooLong[] = {0x80, 0x80, 0x80, 0x00};
+  uint16_t value;
+  TEST_ASSERT_EQUAL_UINT8(0, varintDecode(tooLarge, sizeof(tooLarge), &value));
+  TEST_ASSERT_EQUAL_UINT8(0, varintDecode(tooLong, sizeof(tooLong), &value));
+}
+
+void test_stream_round_trip() {
+  uint8_t bits[16];
+  ElementStream stream;
+  elementStreamInit(stream, bits, sizeof(bits));
+  for (uint8_t i = 0; i < 61; i++) {
+    TEST_ASSERT_TRUE(elementStreamAppend(stream, i * 7 % 4));
+  }
+
+  uint8_t encoded[VARINT_MAX_SIZE + sizeof(bits)];
+  uint8_t size = elementStreamEncode(stream, encoded, sizeof(encoded));
+  const uint8_t* decodedBits = 0;
+  TEST_ASSERT_EQUAL_UINT8(1 + 16, size);
+  TEST_ASSERT_EQUAL_UINT16(61, elementStreamDecode(encoded, size, &decodedBits));
+  for (uint8_t i = 0; i < 61; i++) {
+    TEST_ASSERT_EQUAL_UINT8(i * 7 % 4, elementStreamItem(decodedBits, i));
+  }
+}
+
+void test_stream_append_stops_when_full() {
+  uint8_t bits[2];
+  ElementStream stream;
+  elementStreamInit(stream, bits, sizeof(bits));
+  for (uint8_t i = 0; i < 8; i++) {
+    TEST_ASSERT_TRUE(elementStreamAppend(stream, ELEMENT_DASH));
+  }
+  TEST_ASSERT_FALSE(elementStreamAppend(stream, ELEMENT_DASH));
+  TEST_ASSERT_EQUAL_UINT16(8, stream.count);
+}
+
+void test_decode_rejects_wrong_sizes() {
+  const uint8_t missingBits[] = {5, 0xFF};            // 5 items need 2 bytes
+  const uint8_t extraBits[] = {1, 0xFF, 0xFF};
+  const uint8_t* bits;
+  TEST_ASSERT_EQUAL_UINT16(0, elementStreamDecode(missingBits, sizeof(missingBits), &bits));
+  TEST_ASSERT_EQUAL_UINT16(0, elementStreamDecode(extraBits, sizeof(extraBits), &bits));
+  TEST_ASSERT_EQUAL_UINT16(0, elementStreamDecode(missingBits, 0, &bits));
+}
+
+// Regression: with 16 bit int, count + 3 wrapped for counts from 0xFFFD, so this header alone was accepted as 65535
+// items and playback read 16 KB past the frame
+void test_decode_rejects_wrapping_count() {
+  const uint8_t payload[] = {0xFF, 0xFF, 0x03};
+  const uint8_t* bits;
+  TEST_ASSERT_EQUAL_UINT16(0, elementStreamDecode(payload, sizeof(payload), &bits));
+
+  for (uint32_t count = 0xFFFD; count <= 0xFFFF; count++) {
+    uint8_t header[VARINT_MAX_SIZE];
+    uint8_t size = varintEncode((uint16_t)count, header);
+    TEST_ASSERT_EQUAL_UINT16(0, elementStreamDecode(header, size, &bits));
+  }
+}
+
+void test_decoded_items_stay_inside_the_data() {
+  uint8_t data[3];
+  for (uint32_t value = 0; value < (1UL << 24); value += 3) {
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+    data[2] = (uint8_t)(value >> 16);
+    for (uint8_t length = 0; length <= sizeof(data); length++) {
+      const uint8_t* bits = 0;
+      uint16_t count = elementStreamDecode(data, length, &bits);
+      if (count > 0) {
+        TEST_ASSERT_TRUE(bits >= data && bits + ((uint32_t)count + 3) / 4 <= data + length);
+      }
+    }
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_varint_round_trip);
+  RUN_TEST(test_varint_rejects_values_above_16_bits);
+  RUN_TEST(test_stream_round_trip);
+  RUN_TEST(test_stream_append_stops_when_full);
+  RUN_TEST(test_decode_rejects_wrong_sizes);
+  RUN_TEST(test_decode_rejects_wrapping_count);
+  RUN_TEST(test_decoded_items_stay_inside_the_data);
+  return UNITY_END();
+}
@@ -0,0 +1,149 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+#include "fault_injector.h"
+#include "frame.h"
+#include "rx_parser.h"
+
+static const uint32_t SEED = 1;
+
+struct SweepPoint {
+  uint8_t percent;
+  uint32_t airBytes;                                  // Bytes that reached the receiver
+  uint32_t intact;                                    // Frames received with the payload that was sent
+  uint32_t dropped;                                   // Damaged frames the receiver detected
+  uint32_t undetected;                                // Frames that passed the CRC with a damaged payload
+};
+
+static const uint16_t SWEEP_FRAMES = 2000;
+static const uint8_t SWEEP_PAYLOAD = 16;
+
+/*
+Send the same seeded frames through the injector into the receive parser, as the radio write path and the other
+device's receive path do
+*/
+static SweepPoint sweep(uint8_t _percent) {
+  SweepPoint point = {_percent, 0, 0, 0, 0};
+  FaultInjector faults;
+  RxParser parser;
+
+  faultInit(faults, faultConfigForRate(_percent), SEED);
+  rxParserReset(parser);
+
+  for (uint16_t f = 0; f < SWEEP_FRAMES; f++) {
+    uint8_t payload[SWEEP_PAYLOAD];
+    for (uint8_t i = 0; i < SWEEP_PAYLOAD; i++) {
+      payload[i] = (uint8_t)(f * 7 + i);
+    }
+
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint8_t damaged[2 * FRAME_MAX_SIZE];
+    uint8_t size = frameEncode(FRAME_TEXT, payload, SWEEP_PAYLOAD, frame);
+    uint16_t damagedSize = faultApply(faults, frame, size, damaged);
+    point.airBytes += damagedSize;
+
+    for (uint16_t i = 0; i < damagedSize; i++) {
+      uint8_t event = rxParserFeed(parser, damaged[i]);
+      if (event == RX_FRAME) {
+        const Frame& received = parser.frame.frame;
+        if (received.type == FRAME_TEXT && received.length == SWEEP_PAYLOAD && memcmp(received.payload, payload, SWEEP_PAYLOAD) == 0) {
+          point.intact++;
+        } else {
+          point.undetected++;
+        }
+      } else if (event == RX_FRAME_ERROR) {
+        point.dropped++;
+      }
+    }
+  }
+  return point;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_same_seed_same_faults() {
+  uint8_t data[32];
+  for (uint8_t i = 0; i < sizeof(data); i++) {
+    data[i] = i;
+  }
+
+  FaultInjector first;
+  FaultInjector second;
+  faultInit(first, faultConfigForRate(20), 42);
+  faultInit(second, faultConfigForRate(20), 42);
+  for (uint8_t burst = 0; burst < 100; burst++) {
+    uint8_t firstOut[2 * sizeof(data)];
+    uint8_t secondOut[2 * sizeof(data)];
+    uint16_t firstSize = faultApply(first, data, sizeof(data), firstOut);
+    uint16_t secondSize = faultApply(second, data, sizeof(data), secondOut);
+    TEST_ASSERT_EQUAL_UINT16(firstSize, secondSize);
+    TEST_ASSERT_EQUAL_MEMORY(firstOut, secondOut, firstSize);
+  }
+}
+
+void test_no_faults_at_zero_rate() {
+  uint8_t data[32];
+  uint8_t out[2 * sizeof(data)];
+  FaultInjector faults;
+  faultInit(faults, faultConfigForRate(0), SEED);
+  for (uint8_t i = 0; i < sizeof(data); i++) {
+    data[i] = i * 3;
+  }
+  TEST_ASSERT_EQUAL_UINT16(sizeof(data), faultApply(faults, data, sizeof(data), out));
+  TEST_ASSERT_EQUAL_MEMORY(data, out, sizeof(data));
+}
+
+void test_every_fault_kind_happens() {
+  uint8_t data[32] = {0};
+  uint8_t out[2 * sizeof(data)];
+  FaultInjector faults;
+  faultInit(faults, faultConfigForRate(10), SEED);
+  for (uint16_t burst = 0; burst < 1000; burst++) {
+    TEST_ASSERT_LESS_OR_EQUAL(2 * sizeof(data), faultApply(faults, data, sizeof(data), out));
+  }
+
+  const FaultStats& stats = faults.stats;
+  TEST_ASSERT_EQUAL_UINT32(1000UL * sizeof(data), stats.bytesIn);
+  TEST_ASSERT_GREATER_THAN(0, stats.dropped);
+  TEST_ASSERT_GREATER_THAN(0, stats.flipped);
+  TEST_ASSERT_GREATER_THAN(0, stats.duplicated);
+  TEST_ASSERT_GREATER_THAN(0, stats.reordered);
+  TEST_ASSERT_GREATER_THAN(0, stats.truncated);
+  TEST_ASSERT_GREATER_THAN(0, stats.fadeDropped);
+}
+
+void test_throughput_and_goodput_curves() {
+  const uint8_t rates[] = {0, 1, 2, 5, 10, 20};
+  SweepPoint previous = {0, 0, 0, 0, 0};
+
+  TEST_MESSAGE("Error%  Air Bytes  Intact  Dropped  Undetected  Goodput%");
+  for (uint8_t r = 0; r < sizeof(rates); r++) {
+    SweepPoint point = sweep(rates[r]);
+    char line[80];
+    snprintf(line, sizeof(line), "%6u  %9lu  %6lu  %7lu  %10lu  %8lu", point.percent, (unsigned long)point.airBytes,
+             (unsigned long)point.intact, (unsigned long)point.dropped, (unsigned long)point.undetected,
+             (unsigned long)(100UL * point.intact * SWEEP_PAYLOAD / point.airBytes));
+    TEST_MESSAGE(line);
+
+    if (r == 0) {
+      TEST_ASSERT_EQUAL_UINT32(SWEEP_FRAMES, point.intact);
+      TEST_ASSERT_EQUAL_UINT32(0, point.dropped + point.undetected);
+    } else {
+      TEST_ASSERT_LESS_THAN(previous.intact, point.intact);         // Goodput falls with every step up in errors
+      TEST_ASSERT_GREATER_THAN(previous.dropped, point.dropped);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL(point.dropped / 50 + 1, point.undetected); // CRC-8 lets about 1 in 256 through
+    previous = point;
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_same_seed_same_faults);
+  RUN_TEST(test_no_faults_at_zero_rate);
+  RUN_TEST(test_every_fault_kind_happens);
+  RUN_TEST(test_throughput_and_goodput_curves);
+  return UNITY_END();
+}
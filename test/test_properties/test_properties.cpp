@@ -0,0 +1,152 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+#include "element_stream.h"
+#include "frame.h"
+#include "morse_codec.h"
+#include "morse_timing.h"
+#include "text_compress.h"
+
+static const uint16_t CASES = 5000;                   // Random cases per property
+
+static uint32_t seed = 1;
+
+static uint16_t nextRandom() {
+  seed = seed * 1103515245UL + 12345;
+  return seed >> 16;
+}
+
+void setUp() {
+  seed = 1;
+}
+
+void tearDown() {}
+
+void test_morse_codes_round_trip() {
+  for (uint8_t code = 1; code < 128; code++) {        // Every packed code with 0 to 6 elements
+    uint8_t symbol = morseDecode(code);
+    if (symbol != 0) {
+      TEST_ASSERT_EQUAL_UINT8(code, morseEncode(symbol));
+    }
+  }
+}
+
+void test_text_round_trip() {
+  static const char alphabet[] = "ETAOINSHRDLUCMWFGYPBVKJXQZ0123456789 /?.,";
+  uint16_t compared = 0;
+
+  for (uint16_t c = 0; c < CASES; c++) {
+    uint8_t text[FRAME_MAX_PAYLOAD];
+    uint8_t compressed[FRAME_MAX_PAYLOAD];
+    uint8_t expanded[FRAME_MAX_PAYLOAD * TEXT_MAX_WORD_LENGTH];
+    uint8_t length = 1 + nextRandom() % 20;
+    for (uint8_t i = 0; i < length; i++) {
+      uint16_t pick = nextRandom() % (sizeof(alphabet) - 1 + MORSE_PROSIGN_COUNT);
+      text[i] = pick < sizeof(alphabet) - 1 ? alphabet[pick] : MORSE_PROSIGN + pick - (sizeof(alphabet) - 1);
+    }
+
+    uint8_t size = textCompress(text, length, compressed, sizeof(compressed));
+    if (size == 0) {                                  // Did not fit, nothing to compare
+      continue;
+    }
+    TEST_ASSERT_EQUAL_UINT8(length, textExpand(compressed, size, expanded, sizeof(expanded)));
+    TEST_ASSERT_EQUAL_MEMORY(text, expanded, length);
+    compared++;
+  }
+  TEST_ASSERT_TRUE(compared > CASES / 2);
+}
+
+void test_element_stream_round_trip() {
+  for (uint16_t c = 0; c < CASES; c++) {
+    uint8_t bits[8];
+    uint8_t items[sizeof(bits) * 4];
+    uint8_t serialized[sizeof(bits) + VARINT_MAX_SIZE];
+    ElementStream stream;
+    uint8_t count = 1 + nextRandom() % sizeof(items); // Empty streams are not sent and do not decode
+
+    elementStreamInit(stream, bits, sizeof(bits));
+    for (uint8_t i = 0; i < count; i++) {
+      items[i] = nextRandom() & 3;
+      TEST_ASSERT_TRUE(elementStreamAppend(stream, items[i]));
+    }
+
+    uint8_t size = elementStreamEncode(stream, serialized, sizeof(serialized));
+    const uint8_t* decoded = 0;
+    TEST_ASSERT_NOT_EQUAL(0, size);
+    TEST_ASSERT_EQUAL_UINT16(count, elementStreamDecode(serialized, size, &decoded));
+    for (uint8_t i = 0; i < count; i++) {
+      TEST_ASSERT_EQUAL_UINT8(items[i], elementStreamItem(decoded, i));
+    }
+  }
+}
+
+void test_varint_round_trip() {
+  for (uint32_t value = 0; value <= 0xFFFF; value++) { // Every 16 bit value
+    uint8_t encoded[VARINT_MAX_SIZE];
+    uint16_t decoded = 0;
+    uint8_t size = varintEncode(value, encoded);
+    TEST_ASSERT_EQUAL_UINT8(size, varintDecode(encoded, size, &decoded));
+    TEST_ASSERT_EQUAL_UINT16(value, decoded);
+  }
+}
+
+void test_frame_round_trip() {
+  for (uint16_t c = 0; c < CASES; c++) {
+    uint8_t payload[FRAME_MAX_WIRE_PAYLOAD];
+    uint8_t encoded[FRAME_MAX_SIZE];
+    uint8_t type = nextRandom();
+    uint8_t length = nextRandom() % (FRAME_MAX_WIRE_PAYLOAD + 1);
+    for (uint8_t i = 0; i < length; i++) {
+      payload[i] = nextRandom();
+    }
+
+    uint8_t size = frameEncode(type, payload, length, encoded);
+    FrameParser parser;
+    frameParserReset(parser);
+    TEST_ASSERT_EQUAL_UINT8(length + FRAME_OVERHEAD, size);
+    for (uint8_t i = 0; i < size; i++) {
+      TEST_ASSERT_EQUAL_INT8(i + 1 == size ? FRAME_COMPLETE : FRAME_INCOMPLETE, frameParserFeed(parser, encoded[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT8(type, parser.frame.type);
+    TEST_ASSERT_EQUAL_UINT8(length, parser.frame.length);
+    TEST_ASSERT_EQUAL_MEMORY(payload, parser.frame.payload, length);
+  }
+}
+
+void test_classifier_is_monotonic() {
+  for (uint8_t wpm = 1; wpm <= 40; wpm++) {
+    MorseTiming timing;
+    morseTimingCompute(timing, wpm, 0);
+    uint8_t previous = 0;
+    for (unsigned long duration = 0; duration <= 10UL * timing.dot; duration++) {
+      uint8_t value = morseClassifyPress(timing, duration);
+      TEST_ASSERT_TRUE(value >= previous);
+      previous = value;
+    }
+    TEST_ASSERT_EQUAL_UINT8(2, previous);
+  }
+}
+
+void test_classifier_tolerates_timing_error() {
+  for (uint8_t wpm = 1; wpm <= 40; wpm++) {
+    MorseTiming timing;
+    morseTimingCompute(timing, wpm, 0);
+    long dot = timing.dot;
+    for (long jitter = -25; jitter <= 25; jitter++) {  // -25% to +25% timing error
+      TEST_ASSERT_EQUAL_UINT8(1, morseClassifyPress(timing, dot + dot * jitter / 100));
+      TEST_ASSERT_EQUAL_UINT8(2, morseClassifyPress(timing, 3 * dot + 3 * dot * jitter / 100));
+    }
+  }
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_morse_codes_round_trip);
+  RUN_TEST(test_text_round_trip);
+  RUN_TEST(test_element_stream_round_trip);
+  RUN_TEST(test_varint_round_trip);
+  RUN_TEST(test_frame_round_trip);
+  RUN_TEST(test_classifier_is_monotonic);
+  RUN_TEST(test_classifier_tolerates_timing_error);
+  return UNITY_END();
+}
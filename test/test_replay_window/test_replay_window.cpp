@@ -0,0 +1,121 @@
+#include <stdint.h>
+#include <unity.h>
+#include "replay_window.h"
+
+// Receive side as the firmware keeps it: the window in RAM and the floor it saved in EEPROM
+static ReplayWindow window;
+static uint32_t savedFloor;
+
+// Send side: the next counter in RAM and the reservation it saved in EEPROM
+static uint32_t nextCounter;
+static uint32_t savedReserved;
+
+void setUp() {
+  savedFloor = 0;
+  savedReserved = 0;
+  replayInit(window, savedFloor);
+  nextCounter = savedReserved;
+}
+
+void tearDown() {}
+
+static bool receive(uint32_t _counter) {
+  if (!replayCheck(window, _counter)) {
+    return false;
+  }
+  replayAccept(window, _counter);
+  savedFloor = replayFloorAfter(savedFloor, _counter);
+  return true;
+}
+
+static uint32_t send() {
+  savedReserved = replayReserve(savedReserved, nextCounter);
+  return nextCounter++;
+}
+
+static void reboot() {
+  replayInit(window, savedFloor);                     // What setup() does from the EEPROM
+  nextCounter = savedReserved;
+}
+
+void test_in_order_counters_accepted() {
+  for (uint16_t i = 0; i < 3 * REPLAY_BATCH; i++) {
+    uint32_t counter = send();
+    TEST_ASSERT_EQUAL_UINT32(i, counter);
+    TEST_ASSERT_TRUE(receive(counter));
+  }
+  TEST_ASSERT_EQUAL_UINT32(3 * REPLAY_BATCH, replayNext(window));
+}
+
+void test_duplicate_rejected() {
+  TEST_ASSERT_TRUE(receive(5));
+  TEST_ASSERT_FALSE(receive(5));
+  TEST_ASSERT_TRUE(receive(3));                       // Reordered, still inside the window
+  TEST_ASSERT_FALSE(receive(3));
+  TEST_ASSERT_FALSE(receive(5));
+}
+
+void test_window_edges() {
+  const uint32_t top = 1000;
+  TEST_ASSERT_TRUE(receive(top));
+  TEST_ASSERT_TRUE(replayCheck(window, top - (REPLAY_WINDOW_SIZE - 1))); // Oldest counter the window still tells apart
+  TEST_ASSERT_FALSE(replayCheck(window, top - REPLAY_WINDOW_SIZE));      // Too old to tell, rejected
+  TEST_ASSERT_TRUE(receive(top - (REPLAY_WINDOW_SIZE - 1)));
+  TEST_ASSERT_FALSE(receive(top - (REPLAY_WINDOW_SIZE - 1)));
+}
+
+void test_forward_jump_slides_window() {
+  for (uint32_t counter = 10; counter < 20; counter++) {
+    TEST_ASSERT_TRUE(receive(counter));
+  }
+  TEST_ASSERT_TRUE(receive(100000));                  // A long run of frames lost
+  for (uint32_t counter = 10; counter < 20; counter++) {
+    TEST_ASSERT_FALSE(replayCheck(window, counter));
+  }
+  TEST_ASSERT_FALSE(replayCheck(window, 100000));
+  TEST_ASSERT_TRUE(receive(100000 - 1));              // Lost in the jump, not accepted before
+  TEST_ASSERT_TRUE(receive(100000 - (REPLAY_WINDOW_SIZE - 1)));
+  TEST_ASSERT_EQUAL_UINT32(100001, replayNext(window));
+}
+
+void test_new_batch_accepted_after_reboot() {
+  uint32_t recorded[10];
+  for (uint8_t i = 0; i < 10; i++) {
+    recorded[i] = send();
+    TEST_ASSERT_TRUE(receive(recorded[i]));
+  }
+  TEST_ASSERT_EQUAL_UINT32(REPLAY_BATCH, savedReserved); // One EEPROM write each for the whole batch
+  TEST_ASSERT_EQUAL_UINT32(REPLAY_BATCH, savedFloor);
+
+  reboot();
+  uint32_t counter = send();
+  TEST_ASSERT_EQUAL_UINT32(REPLAY_BATCH, counter);    // Counting resumes in the next batch
+  TEST_ASSERT_TRUE(receive(counter));
+  for (uint8_t i = 0; i < 10; i++) {
+    TEST_ASSERT_FALSE(receive(recorded[i]));          // Frames recorded before the reboot are replays
+  }
+  TEST_ASSERT_FALSE(receive(REPLAY_BATCH - 1));       // Nothing from the old batch, also counters never sent
+}
+
+void test_receiver_reboot_rejects_rest_of_batch() {
+  for (uint8_t i = 0; i < 10; i++) {
+    TEST_ASSERT_TRUE(receive(send()));
+  }
+  reboot();
+  nextCounter = 10;                                   // Only the receiver was reset, the sender goes on counting
+  TEST_ASSERT_FALSE(receive(send()));
+  nextCounter = replayNext(window);                   // Until it is told the floor, see loopCounterSync()
+  TEST_ASSERT_EQUAL_UINT32(REPLAY_BATCH, nextCounter);
+  TEST_ASSERT_TRUE(receive(send()));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_in_order_counters_accepted);
+  RUN_TEST(test_duplicate_rejected);
+  RUN_TEST(test_window_edges);
+  RUN_TEST(test_forward_jump_slides_window);
+  RUN_TEST(test_new_batch_accepted_after_reboot);
+  RUN_TEST(test_receiver_reboot_rejects_rest_of_batch);
+  return UNITY_END();
+}
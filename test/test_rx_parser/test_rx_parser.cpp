@@ -0,0 +1,147 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+#include "element_stream.h"
+#include "rx_parser.h"
+#include "text_compress.h"
+
+static const uint16_t FUZZ_CASES = 20000;
+
+static uint32_t seed = 1;
+
+static uint8_t nextByte() {
+  seed ^= seed << 13;
+  seed ^= seed >> 17;
+  seed ^= seed << 5;
+  return seed >> 8;
+}
+
+void setUp() {
+  seed = 1;
+}
+
+void tearDown() {}
+
+static uint8_t feed(RxParser& _parser, const uint8_t* _data, uint8_t _size, uint8_t _event) {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < _size; i++) {
+    if (rxParserFeed(_parser, _data[i]) == _event) {
+      count++;
+    }
+  }
+  return count;
+}
+
+void test_element_lines() {
+  RxParser parser;
+  rxParserReset(parser);
+  TEST_ASSERT_EQUAL_UINT8(RX_NONE, rxParserFeed(parser, '2'));
+  TEST_ASSERT_EQUAL_UINT8(RX_NONE, rxParserFeed(parser, '\r'));
+  TEST_ASSERT_EQUAL_UINT8(RX_ELEMENT, rxParserFeed(parser, '\n'));
+  TEST_ASSERT_EQUAL_UINT8(2, parser.element);
+
+  const char* invalid = "hello\n";
+  TEST_ASSERT_EQUAL_UINT8(1, feed(parser, (const uint8_t*)invalid, strlen(invalid), RX_INVALID));
+  TEST_ASSERT_FALSE(rxParserBusy(parser));
+}
+
+void test_frame_between_lines() {
+  const uint8_t payload[] = {1, 2, 3};
+  uint8_t stream[4 + FRAME_MAX_SIZE];
+  memcpy(stream, "1\n", 2);
+  uint8_t size = 2 + frameEncode(FRAME_CREDIT, payload, sizeof(payload), stream + 2);
+  memcpy(stream + size, "2\n", 2);
+  size += 2;
+
+  RxParser parser;
+  rxParserReset(parser);
+  uint8_t events[RX_INVALID + 1] = {0};
+  for (uint8_t i = 0; i < size; i++) {
+    events[rxParserFeed(parser, stream[i])]++;
+  }
+  TEST_ASSERT_EQUAL_UINT8(2, events[RX_ELEMENT]);
+  TEST_ASSERT_EQUAL_UINT8(1, events[RX_FRAME]);
+  TEST_ASSERT_EQUAL_UINT8(0, events[RX_FRAME_ERROR] + events[RX_INVALID]);
+  TEST_ASSERT_EQUAL_UINT8(FRAME_CREDIT, parser.frame.frame.type);
+  TEST_ASSERT_EQUAL_MEMORY(payload, parser.frame.frame.payload, sizeof(payload));
+}
+
+void test_resync_after_damaged_frame() {
+  const uint8_t payload[] = {'A', 'B', 'C', 'D'};
+  uint8_t frame[FRAME_MAX_SIZE];
+  uint8_t size = frameEncode(FRAME_TEXT, payload, sizeof(payload), frame);
+
+  // Every cut of a frame swallows at most the next frame, the one after it must always be received
+  for (uint8_t cut = 1; cut < size; cut++) {
+    RxParser parser;
+    rxParserReset(parser);
+    feed(parser, frame, cut, RX_FRAME);
+    feed(parser, frame, size, RX_FRAME);
+    TEST_ASSERT_EQUAL_UINT8(1, feed(parser, frame, size, RX_FRAME));
+    TEST_ASSERT_TRUE(rxParserValid(parser));
+  }
+}
+
+static bool decodeInBounds(const Frame& _frame) {
+  if (_frame.type == FRAME_TEXT) {
+    uint8_t text[FRAME_MAX_PAYLOAD * TEXT_MAX_WORD_LENGTH];
+    return textExpand(_frame.payload, _frame.length, text, sizeof(text)) <= sizeof(text);
+  }
+  if (_frame.type == FRAME_ELEMENTS) {
+    const uint8_t* bits = 0;
+    uint16_t count = elementStreamDecode(_frame.payload, _frame.length, &bits);
+    return count == 0 || (bits >= _frame.payload && bits + ((uint32_t)count + 3) / 4 <= _frame.payload + _frame.length);
+  }
+  return true;
+}
+
+void test_random_streams_keep_invariants() {
+  const uint8_t text[] = "CQ DE AB1CD K";
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+  uint8_t corpus[3][FRAME_MAX_SIZE];
+  uint8_t corpusSize[3];
+  corpusSize[0] = frameEncode(FRAME_TEXT, payload, textCompress(text, sizeof(text) - 1, payload, sizeof(payload)),
+                              corpus[0]);
+  const uint8_t wrapping[] = {0xFF, 0xFF, 0x03};
+  corpusSize[1] = frameEncode(FRAME_ELEMENTS, wrapping, sizeof(wrapping), corpus[1]);
+  memcpy(corpus[2], "1\r\n", 3);
+  corpusSize[2] = 3;
+
+  RxParser parser;
+  rxParserReset(parser);
+  unsigned long frames = 0;
+  for (uint16_t c = 0; c < FUZZ_CASES; c++) {        // The parser carries over between cases like a real stream
+    uint8_t input[64];
+    uint8_t entry = nextByte() % 3;
+    uint8_t size = corpusSize[entry];
+    memcpy(input, corpus[entry], size);
+    uint8_t flips = nextByte() % 4;
+    for (uint8_t i = 0; i < flips; i++) {
+      input[nextByte() % size] ^= 1 << (nextByte() & 7);
+    }
+    uint8_t noise = nextByte() % 8;
+    for (uint8_t i = 0; i < noise; i++) {
+      input[size++] = nextByte();
+    }
+
+    for (uint8_t i = 0; i < size; i++) {
+      uint8_t event = rxParserFeed(parser, input[i]);
+      TEST_ASSERT_TRUE(event <= RX_INVALID);
+      TEST_ASSERT_TRUE(rxParserValid(parser));
+      if (event == RX_FRAME) {
+        frames++;
+        TEST_ASSERT_TRUE(decodeInBounds(parser.frame.frame));
+      }
+    }
+  }
+  TEST_ASSERT_TRUE(frames > FUZZ_CASES / 10);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_element_lines);
+  RUN_TEST(test_frame_between_lines);
+  RUN_TEST(test_resync_after_damaged_frame);
+  RUN_TEST(test_random_streams_keep_invariants);
+  return UNITY_END();
+}
@@ -0,0 +1,128 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+#include "frame.h"
+#include "secure_frame.h"
+
+static const uint8_t key128[SECURE_KEY_SIZE] = {0x3A, 0x91, 0x5C, 0x07, 0xE2, 0x48, 0xB6, 0x1D,
+                                                0x70, 0xC5, 0x2F, 0x83, 0x9E, 0x14, 0x6B, 0xD9};
+static const uint32_t COUNTER = 0x00000123UL;
+
+// Frame with guard bytes on both sides, a failed open must leave all of it untouched
+struct GuardedFrame {
+  uint8_t before[8];
+  Frame frame;
+  uint8_t after[8];
+};
+
+static SecureKey key;
+static uint8_t payload[FRAME_MAX_PAYLOAD];
+static uint8_t sealed[FRAME_MAX_WIRE_PAYLOAD];
+static uint8_t sealedLength;
+
+void setUp() {
+  secureKeyInit(key, key128);
+  for (uint8_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = i * 37 + 11;
+  }
+  sealedLength = secureSeal(key, COUNTER, FRAME_TEXT, payload, 20, sealed);
+}
+
+void tearDown() {}
+
+/*
+@brief Open a sealed payload that must be rejected, and check that nothing was written
+*/
+static void assertOpenFails(const SecureKey& _key, const uint8_t* _data, uint8_t _length) {
+  GuardedFrame guarded;
+  GuardedFrame untouched;
+  uint32_t counter = 0xA5A5A5A5UL;
+  memset(&guarded, 0xA5, sizeof(guarded));
+  memcpy(&untouched, &guarded, sizeof(guarded));
+
+  TEST_ASSERT_FALSE(secureOpen(_key, _data, _length, &counter, guarded.frame));
+  TEST_ASSERT_EQUAL_MEMORY(&untouched, &guarded, sizeof(guarded));
+  TEST_ASSERT_EQUAL_HEX32(0xA5A5A5A5UL, counter);
+}
+
+void test_speck_test_vector() {
+  const uint8_t testKey[SECURE_KEY_SIZE] = {0x00, 0x01, 0x02, 0x03, 0x08, 0x09, 0x0A, 0x0B,
+                                            0x10, 0x11, 0x12, 0x13, 0x18, 0x19, 0x1A, 0x1B};
+  SecureKey vectorKey;
+  uint32_t block[2] = {0x7475432DUL, 0x3B726574UL};  // Plaintext 3b726574 7475432d
+  secureKeyInit(vectorKey, testKey);
+  speckEncrypt(vectorKey, block);
+  TEST_ASSERT_EQUAL_HEX32(0x8C6FA548UL, block[1]);    // Ciphertext 8c6fa548 454e028b
+  TEST_ASSERT_EQUAL_HEX32(0x454E028BUL, block[0]);
+}
+
+void test_seal_open_round_trip() {
+  for (uint8_t length = 0; length <= FRAME_MAX_PAYLOAD; length++) {
+    uint8_t out[FRAME_MAX_WIRE_PAYLOAD];
+    uint8_t size = secureSeal(key, COUNTER + length, FRAME_ELEMENTS, payload, length, out);
+    TEST_ASSERT_EQUAL_UINT8(length + FRAME_SECURE_OVERHEAD, size);
+
+    Frame inner;
+    uint32_t counter = 0;
+    TEST_ASSERT_TRUE(secureOpen(key, out, size, &counter, inner));
+    TEST_ASSERT_EQUAL_HEX32(COUNTER + length, counter);
+    TEST_ASSERT_EQUAL_UINT8(FRAME_ELEMENTS, inner.type);
+    TEST_ASSERT_EQUAL_UINT8(length, inner.length);
+    TEST_ASSERT_EQUAL_MEMORY(payload, inner.payload, length);
+  }
+  uint8_t out[FRAME_MAX_WIRE_PAYLOAD + 1];
+  TEST_ASSERT_EQUAL_UINT8(0, secureSeal(key, COUNTER, FRAME_TEXT, payload, FRAME_MAX_PAYLOAD + 1, out));
+}
+
+void test_flipped_tag_byte_fails() {
+  for (uint8_t i = sealedLength - SECURE_TAG_SIZE; i < sealedLength; i++) {
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      sealed[i] ^= 1 << bit;
+      assertOpenFails(key, sealed, sealedLength);
+      sealed[i] ^= 1 << bit;
+    }
+  }
+}
+
+void test_flipped_ciphertext_byte_fails() {
+  for (uint8_t i = 0; i < sealedLength - SECURE_TAG_SIZE; i++) { // The counter is authenticated too
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      sealed[i] ^= 1 << bit;
+      assertOpenFails(key, sealed, sealedLength);
+      sealed[i] ^= 1 << bit;
+    }
+  }
+}
+
+void test_wrong_key_fails() {
+  for (uint8_t i = 0; i < SECURE_KEY_SIZE; i++) {
+    uint8_t otherKey128[SECURE_KEY_SIZE];
+    SecureKey otherKey;
+    memcpy(otherKey128, key128, sizeof(otherKey128));
+    otherKey128[i] ^= 0x01;
+    secureKeyInit(otherKey, otherKey128);
+    assertOpenFails(otherKey, sealed, sealedLength);
+  }
+}
+
+void test_truncated_frame_fails() {
+  for (uint8_t length = 0; length < sealedLength; length++) {
+    uint8_t cut[FRAME_MAX_WIRE_PAYLOAD];              // At the end of the buffer, reading past it is out of bounds
+    uint8_t* start = cut + sizeof(cut) - length;
+    memcpy(start, sealed, length);
+    assertOpenFails(key, start, length);
+  }
+  uint8_t tooLong[FRAME_MAX_WIRE_PAYLOAD + 1] = {0};
+  assertOpenFails(key, tooLong, sizeof(tooLong));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_speck_test_vector);
+  RUN_TEST(test_seal_open_round_trip);
+  RUN_TEST(test_flipped_tag_byte_fails);
+  RUN_TEST(test_flipped_ciphertext_byte_fails);
+  RUN_TEST(test_wrong_key_fails);
+  RUN_TEST(test_truncated_frame_fails);
+  return UNITY_END();
+}
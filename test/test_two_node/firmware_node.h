@@ -0,0 +1,94 @@
+/*
+@brief Builds the whole firmware into one unit of the two node test
+@details Include with FIRMWARE set to a namespace name, once per unit for each FIRMWARE_PART, and with NODE set to the
+         name of the Node to define for part 0. The host Arduino core in fuzz/host/ and every file of src/ are
+         included inside the namespace, so the units share nothing. The C headers they use are included first, outside
+         of it. The files of src/ are spread over three translation units, as main.cpp, channel_switch.cpp and
+         playback.cpp each have file local names that another of them uses too.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "two_node.h"
+
+namespace FIRMWARE {
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SoftwareSerial.h>
+
+#if FIRMWARE_PART == 0
+#include "../../src/main.cpp"
+#elif FIRMWARE_PART == 1
+#include "../../src/adc_sampler.cpp"
+#include "../../src/beam_decoder.cpp"
+#include "../../src/channel_scan.cpp"
+#include "../../src/channel_switch.cpp"
+#include "../../src/crypt_benchmark.cpp"
+#include "../../src/dsp.cpp"
+#include "../../src/dsp_benchmark.cpp"
+#include "../../src/dsp_workload.cpp"
+#include "../../src/element_stream.cpp"
+#include "../../src/fault_injector.cpp"
+#include "../../src/frame.cpp"
+#include "../../src/gesture.cpp"
+#include "../../src/hop_schedule.cpp"
+#include "../../src/key_script.cpp"
+#include "../../src/key_store.cpp"
+#include "../../src/loopback_stream.cpp"
+#include "../../src/morse_codec.cpp"
+#include "../../src/morse_timing.cpp"
+#include "../../src/replay_window.cpp"
+#include "../../src/rx_parser.cpp"
+#include "../../src/secure_frame.cpp"
+#include "../../src/serial_shell.cpp"
+#include "../../src/text_compress.cpp"
+#include "../../src/trace.cpp"
+#else
+#include "../../src/playback.cpp"
+#include "../../src/tone_input.cpp"
+#endif
+
+#if FIRMWARE_PART == 0
+static uint64_t nodeTime() {
+  return hostMicros;
+}
+
+static void nodeAdvanceTo(uint64_t _micros) {
+  if (_micros > hostMicros) {
+    hostMicros = _micros;
+  }
+}
+
+static void nodeKey(bool _down) {
+  digitalWrite(BUTTON_PIN, _down ? LOW : HIGH);
+}
+
+static bool nodeSounding() {
+  return digitalRead(BUZZER_PIN) == HIGH;
+}
+
+static int nodeTakeRadio(uint64_t* _time) {
+  return morse.hostTake(_time);
+}
+
+static bool nodeFeedRadio(uint8_t _value) {
+  return morse.hostFeed(_value);
+}
+
+static int nodeTakeConsole() {
+  return Serial.hostTake();
+}
+#endif
+
+}  // namespace FIRMWARE
+
+#if FIRMWARE_PART == 0
+extern const Node NODE = {FIRMWARE::setup,         FIRMWARE::loop,          FIRMWARE::nodeTime,
+                          FIRMWARE::nodeAdvanceTo, FIRMWARE::nodeKey,       FIRMWARE::nodeSounding,
+                          FIRMWARE::nodeTakeRadio, FIRMWARE::nodeFeedRadio, FIRMWARE::nodeTakeConsole};
+#endif
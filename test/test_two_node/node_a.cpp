@@ -0,0 +1,4 @@
+#define FIRMWARE firmwareA
+#define FIRMWARE_PART 0
+#define NODE nodeA
+#include "firmware_node.h"
@@ -0,0 +1,3 @@
+#define FIRMWARE firmwareA
+#define FIRMWARE_PART 1
+#include "firmware_node.h"
@@ -0,0 +1,3 @@
+#define FIRMWARE firmwareA
+#define FIRMWARE_PART 2
+#include "firmware_node.h"
@@ -0,0 +1,4 @@
+#define FIRMWARE firmwareB
+#define FIRMWARE_PART 0
+#define NODE nodeB
+#include "firmware_node.h"
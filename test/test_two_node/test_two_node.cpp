@@ -0,0 +1,204 @@
+#include <stdint.h>
+#include <string.h>
+#include <unity.h>
+#include "two_node.h"
+
+static const uint64_t STEP_US = 100;                  // Simulated time between loop() passes when a unit is idle
+static const uint64_t AIR_LATENCY_US = 4000;          // HC-12 transmit to receive at FU3, as in the loopback stream
+static const unsigned long DOT_MS = 600;              // One dot at keyingWpm 2
+static const unsigned long DASH_MS = 3 * DOT_MS;
+static const unsigned long GAP_MS = DOT_MS;           // Between elements of one character
+static const uint64_t LATENCY_BOUND_US = 50000;       // Release of the key to the other unit's sounder
+
+// Bytes on their way from one unit's HC-12 to the other's
+struct Air {
+  uint8_t value[512];
+  uint64_t arrival[512];
+  uint16_t head;
+  uint16_t count;
+};
+
+// Buzzer on and off times of one unit, in microseconds
+struct Sounds {
+  uint64_t start[16];
+  uint64_t end[16];
+  uint8_t count;
+  bool on;
+};
+
+// One unit and everything the test records about it
+struct Unit {
+  const Node* node;
+  Air air;                                            // Towards this unit
+  Sounds sounds;
+  char console[2048];                                 // What it printed since setUp()
+  uint16_t consoleLength;
+  unsigned long lost;                                 // Bytes that did not fit into its receive buffer
+};
+
+static Unit units[2];
+static uint64_t now = 0;
+
+static void deliver(Unit& _unit) {
+  while (_unit.air.count > 0 && _unit.air.arrival[_unit.air.head] <= _unit.node->time()) {
+    if (!_unit.node->feedRadio(_unit.air.value[_unit.air.head])) {
+      _unit.lost++;
+    }
+    _unit.air.head = (_unit.air.head + 1) % sizeof(_unit.air.value);
+    _unit.air.count--;
+  }
+}
+
+static void transmit(Unit& _unit, Unit& _peer) {
+  uint64_t time;
+  int value;
+  while ((value = _unit.node->takeRadio(&time)) >= 0) {
+    TEST_ASSERT_TRUE(_peer.air.count < sizeof(_peer.air.value));
+    uint16_t tail = (_peer.air.head + _peer.air.count++) % sizeof(_peer.air.value);
+    _peer.air.value[tail] = value;
+    _peer.air.arrival[tail] = time + AIR_LATENCY_US;
+  }
+}
+
+static void record(Unit& _unit) {
+  int value;
+  while ((value = _unit.node->takeConsole()) >= 0) {
+    if (_unit.consoleLength < sizeof(_unit.console) - 1) {
+      _unit.console[_unit.consoleLength++] = value;
+    }
+  }
+
+  bool on = _unit.node->sounding();
+  if (on != _unit.sounds.on && _unit.sounds.count < sizeof(_unit.sounds.start) / sizeof(_unit.sounds.start[0])) {
+    if (on) {
+      _unit.sounds.start[_unit.sounds.count] = _unit.node->time();
+    } else {
+      _unit.sounds.end[_unit.sounds.count++] = _unit.node->time();
+    }
+  }
+  _unit.sounds.on = on;
+}
+
+/*
+@brief Run both units side by side for a while
+@details Each unit runs loop() whenever its clock is behind the common time. A pass that writes to the HC-12 moves the
+         unit's clock on by the time the bytes take, and the unit waits until the other one has caught up.
+*/
+static void run(unsigned long _milliseconds) {
+  uint64_t end = now + _milliseconds * 1000ULL;
+  while (now < end) {
+    now += STEP_US;
+    for (uint8_t i = 0; i < 2; i++) {
+      Unit& unit = units[i];
+      if (unit.node->time() > now) {
+        continue;
+      }
+      unit.node->advanceTo(now);
+      deliver(unit);
+      unit.node->loop();
+      transmit(unit, units[1 - i]);
+      record(unit);
+    }
+  }
+}
+
+/*
+@brief Press the button of a unit for a while, then release it
+@return Time of the release on the common clock
+*/
+static uint64_t key(Unit& _unit, unsigned long _milliseconds) {
+  _unit.node->key(true);
+  run(_milliseconds);
+  _unit.node->key(false);
+  return now;
+}
+
+static void startUnit(Unit& _unit, const Node& _node) {
+  memset(&_unit, 0, sizeof(_unit));
+  _unit.node = &_node;
+  const char reply[] = "OK\r\n";                      // The HC-12 answering setupHc12()
+  for (uint8_t i = 0; i < sizeof(reply) - 1; i++) {
+    _node.feedRadio(reply[i]);
+  }
+  _node.setup();
+  while (_node.takeRadio(0) >= 0) {}                  // The AT command, for the module and not sent
+  if (_node.time() > now) {
+    now = _node.time();
+  }
+}
+
+void setUp() {
+  run(3000);                                          // Finish everything still going, e.g. the beeps after setup()
+  for (uint8_t i = 0; i < 2; i++) {
+    units[i].sounds.count = 0;
+    units[i].consoleLength = 0;
+    units[i].console[0] = '\0';
+  }
+}
+
+void tearDown() {
+  TEST_ASSERT_EQUAL_UINT32(0, units[0].lost);
+  TEST_ASSERT_EQUAL_UINT32(0, units[1].lost);
+}
+
+void test_setup_succeeds() {
+  for (uint8_t i = 0; i < 2; i++) {
+    TEST_ASSERT_FALSE(units[i].sounds.on);
+    TEST_ASSERT_EQUAL_UINT16(0, units[i].air.count);
+  }
+}
+
+void test_dot_sounds_on_other_unit() {
+  uint64_t release = key(units[0], DOT_MS);
+  run(2000);
+  units[1].console[units[1].consoleLength] = '\0';
+
+  TEST_ASSERT_EQUAL_UINT8(1, units[1].sounds.count);
+  TEST_ASSERT_TRUE(units[1].sounds.start[0] >= release);
+  TEST_ASSERT_TRUE(units[1].sounds.start[0] - release < LATENCY_BOUND_US);
+  TEST_ASSERT_NOT_NULL(strstr(units[1].console, "Received: 1"));
+
+  char line[64];
+  snprintf(line, sizeof(line), "Key release to sounder: %lu us", (unsigned long)(units[1].sounds.start[0] - release));
+  TEST_MESSAGE(line);
+}
+
+void test_elements_play_in_order() {
+  const unsigned long presses[] = {DOT_MS, DASH_MS, DOT_MS, DASH_MS};
+  for (uint8_t i = 0; i < 4; i++) {
+    key(units[0], presses[i]);
+    run(GAP_MS);
+  }
+  run(3000);
+
+  Sounds& sounds = units[1].sounds;
+  TEST_ASSERT_EQUAL_UINT8(4, sounds.count);
+  for (uint8_t i = 0; i < 4; i += 2) {
+    TEST_ASSERT_TRUE(sounds.end[i] - sounds.start[i] < sounds.end[i + 1] - sounds.start[i + 1]);
+  }
+  for (uint8_t i = 1; i < 4; i++) {
+    TEST_ASSERT_TRUE(sounds.start[i] >= sounds.end[i - 1]);
+  }
+}
+
+void test_other_direction() {
+  uint64_t release = key(units[1], DASH_MS);
+  run(3000);
+  units[0].console[units[0].consoleLength] = '\0';
+
+  TEST_ASSERT_EQUAL_UINT8(1, units[0].sounds.count);
+  TEST_ASSERT_TRUE(units[0].sounds.start[0] - release < LATENCY_BOUND_US);
+  TEST_ASSERT_NOT_NULL(strstr(units[0].console, "Received: 2"));
+}
+
+int main() {
+  startUnit(units[0], nodeA);
+  startUnit(units[1], nodeB);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_setup_succeeds);
+  RUN_TEST(test_dot_sounds_on_other_unit);
+  RUN_TEST(test_elements_play_in_order);
+  RUN_TEST(test_other_direction);
+  return UNITY_END();
+}
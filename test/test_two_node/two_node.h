@@ -0,0 +1,26 @@
+#ifndef TWO_NODE_H
+#define TWO_NODE_H
+
+#include <stdint.h>
+
+/*
+@brief One unit running the whole firmware on the host, see firmware_node.h
+@details Every unit has its own copy of the firmware and of the host Arduino core, and with it its own clock, pins,
+         serial ports and EEPROM. The test moves bytes between the HC-12 ports of the two units.
+*/
+struct Node {
+  void (*setup)();
+  void (*loop)();
+  uint64_t (*time)();                                 // Microseconds on this unit's clock
+  void (*advanceTo)(uint64_t _micros);                // Moves the clock forward, never back
+  void (*key)(bool _down);                            // Presses or releases the button
+  bool (*sounding)();                                 // True while the buzzer is on
+  int (*takeRadio)(uint64_t* _time);                  // Oldest byte written to the HC-12 and when, -1 if none
+  bool (*feedRadio)(uint8_t _value);                  // Byte from the HC-12, false if the receive buffer is full
+  int (*takeConsole)();                               // Oldest byte written to the serial monitor, -1 if none
+};
+
+extern const Node nodeA;
+extern const Node nodeB;
+
+#endif